@@ -0,0 +1,109 @@
+#include <cvx/concurrent_union_find.hpp>
+#include <cvx/union_find.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using hires_clock = std::chrono::high_resolution_clock;
+using merge_list = std::vector<std::pair<int, int>>;
+
+// Stress test of concurrent merges. Each scenario generates a list of
+// merges that every thread executes a slice of:
+//
+//   uniform: Random pairs over all labels (low contention)
+//   hotspot: Every merge involves one of a handful of labels (high contention)
+//   chain:   Neighbouring labels are merged, building long paths
+merge_list make_merges(const std::string& scenario, int label_count, int merge_count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> any(1, label_count - 1);
+    std::uniform_int_distribution<int> hot(1, 8);
+    merge_list merges;
+
+    for (int i = 0; i < merge_count; ++i) {
+        if (scenario == "uniform") {
+            merges.emplace_back(any(rng), any(rng));
+        } else if (scenario == "hotspot") {
+            merges.emplace_back(hot(rng), any(rng));
+        } else {
+            int label = 1 + i % (label_count - 2);
+            merges.emplace_back(label + 1, label);
+        }
+    }
+
+    return merges;
+}
+
+template<typename Function>
+double run_threads(int thread_count, std::size_t merge_count, Function function) {
+    std::vector<std::thread> threads;
+    auto start = hires_clock::now();
+
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([=]() {
+            for (std::size_t i = t; i < merge_count; i += thread_count) {
+                function(i);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return std::chrono::duration<double, std::milli>(hires_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const int label_count = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    const int merge_count = argc > 2 ? std::atoi(argv[2]) : 1 << 22;
+    const int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 rng(1);
+
+    std::cout << "labels: " << label_count << ", merges: " << merge_count << std::endl;
+    std::cout << "scenario  threads  locked (ms)  lock-free (ms)  speedup" << std::endl;
+
+    for (const std::string scenario : { "uniform", "hotspot", "chain" }) {
+        const merge_list merges = make_merges(scenario, label_count, merge_count, rng);
+
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            // Baseline: a sequential union-find behind a global lock
+            cvx::union_find<int> locked_labels(label_count);
+            std::mutex mutex;
+
+            for (int i = 1; i < label_count; ++i) {
+                locked_labels.push_back(i);
+            }
+
+            double locked = run_threads(threads, merges.size(), [&](std::size_t i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked_labels.merge(merges[i].first, merges[i].second);
+            });
+
+            cvx::concurrent_union_find<int> labels(label_count);
+
+            double lock_free = run_threads(threads, merges.size(), [&](std::size_t i) {
+                labels.merge(merges[i].first, merges[i].second);
+            });
+
+            // Both must agree on the final sets
+            locked_labels.flatten();
+            labels.flatten();
+
+            if (labels.label_count() != locked_labels.label_count()) {
+                std::cerr << "Mismatching label counts for " << scenario << std::endl;
+                return 1;
+            }
+
+            std::cout << scenario << "  " << threads << "  " << locked << "  " << lock_free
+                      << "  " << locked / lock_free << std::endl;
+        }
+    }
+
+    return 0;
+}
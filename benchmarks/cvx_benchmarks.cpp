@@ -0,0 +1,359 @@
+#include <cvx.hpp>
+#include <cvx/detail/simd.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using hires_clock = std::chrono::high_resolution_clock;
+using image = std::vector<int>;
+
+// Synthetic images, all generated from a fixed seed so that runs are
+// comparable across commits:
+//
+//   noise-N:        Uniform random noise with N% foreground
+//   granularity-G:  Random noise of GxG cells at 50% foreground
+//   spiral:         A single thick spiral, one long winding component
+//   checkerboard:   Alternating pixels, worst case for 4-connectivity
+//   blobs:          Large filled discs with holes, few long runs
+struct pattern {
+    std::string name;
+    image data;
+};
+
+image make_noise(std::size_t width, std::size_t height, double density, std::mt19937& rng) {
+    std::bernoulli_distribution dist(density);
+    image data(width * height);
+
+    for (auto& e : data) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    return data;
+}
+
+image make_granularity(std::size_t width, std::size_t height, std::size_t granularity, std::mt19937& rng) {
+    std::bernoulli_distribution dist(0.5);
+    image data(width * height);
+
+    for (std::size_t y = 0; y < height; y += granularity) {
+        for (std::size_t x = 0; x < width; x += granularity) {
+            const int value = dist(rng) ? 1 : 0;
+
+            for (std::size_t cy = y; cy < std::min(y + granularity, height); ++cy) {
+                std::fill(data.begin() + cy * width + x,
+                          data.begin() + cy * width + std::min(x + granularity, width),
+                          value);
+            }
+        }
+    }
+
+    return data;
+}
+
+image make_spiral(std::size_t width, std::size_t height) {
+    image data(width * height);
+    const double cx = width / 2.0;
+    const double cy = height / 2.0;
+    const double spacing = 8.0;
+
+    // Foreground where the radius lies on an arm of an archimedean spiral
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            const double dx = x - cx;
+            const double dy = y - cy;
+            const double turn = (std::atan2(dy, dx) + M_PI) / (2 * M_PI);
+            const double phase = std::fmod(std::sqrt(dx * dx + dy * dy) / spacing - turn, 1.0);
+
+            data[y * width + x] = (phase < 0.5 ? 1 : 0);
+        }
+    }
+
+    return data;
+}
+
+image make_checkerboard(std::size_t width, std::size_t height) {
+    image data(width * height);
+
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            data[y * width + x] = ((x + y) % 2 ? 1 : 0);
+        }
+    }
+
+    return data;
+}
+
+image make_blobs(std::size_t width, std::size_t height, std::mt19937& rng) {
+    image data(width * height);
+    const std::size_t count = std::max<std::size_t>(1, width * height / 4096);
+    const double max_radius = std::max(4.0, std::min(width, height) / 8.0);
+    std::uniform_real_distribution<double> x_dist(0, width);
+    std::uniform_real_distribution<double> y_dist(0, height);
+    std::uniform_real_distribution<double> r_dist(4, max_radius);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const double bx = x_dist(rng);
+        const double by = y_dist(rng);
+        const double radius = r_dist(rng);
+        const double hole = radius / 3;
+
+        const std::size_t x0 = static_cast<std::size_t>(std::max(0.0, bx - radius));
+        const std::size_t x1 = static_cast<std::size_t>(std::min<double>(width, bx + radius + 1));
+        const std::size_t y0 = static_cast<std::size_t>(std::max(0.0, by - radius));
+        const std::size_t y1 = static_cast<std::size_t>(std::min<double>(height, by + radius + 1));
+
+        for (std::size_t y = y0; y < y1; ++y) {
+            for (std::size_t x = x0; x < x1; ++x) {
+                const double distance = std::hypot(x - bx, y - by);
+
+                if (distance <= radius) {
+                    data[y * width + x] = (distance > hole ? 1 : 0);
+                }
+            }
+        }
+    }
+
+    return data;
+}
+
+std::vector<pattern> make_patterns(std::size_t width, std::size_t height) {
+    std::mt19937 rng(1);
+    std::vector<pattern> patterns;
+
+    for (int density : { 10, 30, 50, 70, 90 }) {
+        patterns.push_back(pattern{ "noise-" + std::to_string(density),
+                                    make_noise(width, height, density / 100.0, rng) });
+    }
+
+    for (std::size_t granularity : { 2, 4, 16 }) {
+        patterns.push_back(pattern{ "granularity-" + std::to_string(granularity),
+                                    make_granularity(width, height, granularity, rng) });
+    }
+
+    patterns.push_back(pattern{ "spiral", make_spiral(width, height) });
+    patterns.push_back(pattern{ "checkerboard", make_checkerboard(width, height) });
+    patterns.push_back(pattern{ "blobs", make_blobs(width, height, rng) });
+
+    return patterns;
+}
+
+std::string engine_name(cvx::label_engine engine) {
+    switch (engine) {
+        case cvx::label_engine::block:
+            return "block";
+        case cvx::label_engine::run:
+            return "run";
+        default:
+            return "pixel";
+    }
+}
+
+std::string flags_name(cvx::feature_flag flags) {
+    static const std::pair<cvx::feature_flag, const char*> names[] = {
+        { cvx::feature_flag::area,           "area" },
+        { cvx::feature_flag::centroid,       "centroid" },
+        { cvx::feature_flag::points,         "points" },
+        { cvx::feature_flag::bounding_box,   "bounding_box" },
+        { cvx::feature_flag::extent,         "extent" },
+        { cvx::feature_flag::outer_contours, "outer_contours" },
+        { cvx::feature_flag::inner_contours, "inner_contours" }
+    };
+
+    std::string name;
+
+    for (const auto& entry : names) {
+        // Extent includes the bounding box, so flags must match in full
+        if ((flags & entry.first) == entry.first) {
+            name += (name.empty() ? "" : "|") + std::string(entry.second);
+        }
+    }
+
+    return name.empty() ? "none" : name;
+}
+
+struct result {
+    std::string pattern;
+    unsigned int connectivity;
+    std::string engine;
+    std::string features;
+    std::size_t components;
+    double ms_per_frame;
+    double min_ms;
+    double mpixels_per_second;
+};
+
+result run(const pattern& pattern,
+           std::size_t width,
+           std::size_t height,
+           std::size_t frames,
+           unsigned char connectivity,
+           cvx::label_engine engine,
+           cvx::feature_flag flags) {
+    cvx::labeler<int> labeler(connectivity, flags, engine);
+    image input(pattern.data);
+    image labels(input.size());
+    cvx::array_view<image::iterator> input_view(input.begin(), input.end(), width, height);
+    cvx::array_view<image::iterator> label_view(labels.begin(), labels.end(), width, height);
+    std::vector<double> times;
+    std::size_t components = 0;
+
+    // One untimed frame to size the scratch memory of the labeler
+    labeler.label(input_view, label_view, 1, 0);
+
+    for (std::size_t i = 0; i < frames; ++i) {
+        auto start = hires_clock::now();
+        components = labeler.label(input_view, label_view, 1, 0);
+        times.push_back(std::chrono::duration<double, std::milli>(hires_clock::now() - start).count());
+    }
+
+    // The median is robust against the occasional preempted frame
+    std::sort(times.begin(), times.end());
+    const double median = times[times.size() / 2];
+
+    return result{ pattern.name,
+                   connectivity,
+                   engine_name(engine),
+                   flags_name(flags),
+                   components,
+                   median,
+                   times.front(),
+                   width * height / (median * 1000.0) };
+}
+
+void write_json(std::ostream& out,
+                std::size_t width,
+                std::size_t height,
+                std::size_t frames,
+                const std::vector<result>& results) {
+    out << "{\n"
+        << "  \"version\": \"" << cvx::version_string << "\",\n"
+        << "  \"simd\": \"" << cvx::detail::simd_kernel_name() << "\",\n"
+        << "  \"width\": " << width << ",\n"
+        << "  \"height\": " << height << ",\n"
+        << "  \"frames\": " << frames << ",\n"
+        << "  \"results\": [\n";
+
+    out << std::fixed << std::setprecision(4);
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const result& r = results[i];
+
+        out << "    { \"pattern\": \"" << r.pattern << "\""
+            << ", \"connectivity\": " << r.connectivity
+            << ", \"engine\": \"" << r.engine << "\""
+            << ", \"features\": \"" << r.features << "\""
+            << ", \"components\": " << r.components
+            << ", \"ms_per_frame\": " << r.ms_per_frame
+            << ", \"min_ms\": " << r.min_ms
+            << ", \"mpixels_per_second\": " << r.mpixels_per_second
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n}\n";
+}
+
+// Usage: cvx_benchmarks [width] [height] [frames] [json output path]
+//
+// Every pattern is labelled with each engine and connectivity, and with
+// the pixel engine for every combination of the per-pixel features and,
+// at connectivity 8, for the contour tracing path. A table is printed as
+// it runs, to standard error if the JSON goes to standard output, and the
+// results are written as JSON for tracking regressions across commits
+int main(int argc, char** argv) {
+    const std::size_t width = argc > 1 ? std::atoi(argv[1]) : 512;
+    const std::size_t height = argc > 2 ? std::atoi(argv[2]) : 512;
+    const std::size_t frames = std::max(1, argc > 3 ? std::atoi(argv[3]) : 10);
+    const std::string json_path = argc > 4 ? argv[4] : "cvx_benchmarks.json";
+
+    const cvx::label_engine engines[] = { cvx::label_engine::pixel,
+                                          cvx::label_engine::block,
+                                          cvx::label_engine::run };
+
+    const cvx::feature_flag pixel_features[] = { cvx::feature_flag::area,
+                                                 cvx::feature_flag::centroid,
+                                                 cvx::feature_flag::points,
+                                                 cvx::feature_flag::bounding_box,
+                                                 cvx::feature_flag::extent };
+
+    std::vector<result> results;
+
+    // Keep standard output valid JSON when the results are written to it
+    std::ostream& table = (json_path == "-" ? std::cerr : std::cout);
+
+    table << "size: " << width << "x" << height << ", frames: " << frames
+          << ", simd: " << cvx::detail::simd_kernel_name() << std::endl;
+    table << "pattern  connectivity  engine  features  components  ms/frame  Mpixel/s" << std::endl;
+
+    try {
+        for (const pattern& pattern : make_patterns(width, height)) {
+            for (unsigned char connectivity : { 4, 8 }) {
+                std::vector<std::pair<cvx::label_engine, cvx::feature_flag>> cases;
+
+                for (cvx::label_engine engine : engines) {
+                    cases.emplace_back(engine, cvx::feature_flag::none);
+                }
+
+                // All distinct non-empty subsets of the per-pixel features.
+                // Extent includes the bounding box, so subsets with both
+                // are skipped
+                for (unsigned int subset = 1; subset < (1u << 5); ++subset) {
+                    cvx::feature_flag flags = cvx::feature_flag::none;
+
+                    if ((subset & (1u << 3)) && (subset & (1u << 4))) {
+                        continue;
+                    }
+
+                    for (unsigned int bit = 0; bit < 5; ++bit) {
+                        if (subset & (1u << bit)) {
+                            flags = flags | pixel_features[bit];
+                        }
+                    }
+
+                    cases.emplace_back(cvx::label_engine::pixel, flags);
+                }
+
+                // Contour tracing always follows 8-connected components
+                if (connectivity == 8) {
+                    cases.emplace_back(cvx::label_engine::pixel, cvx::feature_flag::outer_contours);
+                    cases.emplace_back(cvx::label_engine::pixel, cvx::feature_flag::all_contours);
+                }
+
+                for (const auto& c : cases) {
+                    results.push_back(run(pattern, width, height, frames, connectivity, c.first, c.second));
+
+                    const result& r = results.back();
+                    table << r.pattern << "  " << r.connectivity << "  " << r.engine << "  "
+                          << r.features << "  " << r.components << "  " << r.ms_per_frame
+                          << "  " << r.mpixels_per_second << std::endl;
+                }
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (json_path == "-") {
+        write_json(std::cout, width, height, frames, results);
+    } else {
+        std::ofstream file(json_path);
+
+        if (!file) {
+            std::cerr << "Unable to write " << json_path << std::endl;
+            return 1;
+        }
+
+        write_json(file, width, height, frames, results);
+        std::cout << "Results written to " << json_path << std::endl;
+    }
+
+    return 0;
+}
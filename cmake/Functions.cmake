@@ -2,6 +2,7 @@
 function(cvx_build_example target)
     add_executable(${target} ${target}.cpp ${CVX_SOURCES})
     set_target_properties(${target} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${PROJECT_SOURCE_DIR}/examples/bin)
+    target_link_libraries(${target} ${CMAKE_THREAD_LIBS_INIT})
 
     if(${CVX_WITH_OPENCV} AND OpenCV_FOUND)
         target_link_libraries(${target} ${OpenCV_LIBS})
@@ -12,6 +13,7 @@ endfunction()
 function(cvx_build_test target)
     add_executable(${target} ${target}.cpp ${CVX_SOURCES})
     set_target_properties(${target} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${PROJECT_SOURCE_DIR}/tests/bin)
+    target_link_libraries(${target} ${CMAKE_THREAD_LIBS_INIT})
 
     if(${CVX_WITH_OPENCV} AND OpenCV_FOUND)
         target_link_libraries(${target} ${OpenCV_LIBS})
@@ -19,3 +21,10 @@ function(cvx_build_test target)
 
     add_test(${target} ${PROJECT_SOURCE_DIR}/tests/bin/${target})
 endfunction()
+
+# Function for building a cvx benchmark
+function(cvx_build_benchmark target)
+    add_executable(${target} ${target}.cpp ${CVX_SOURCES})
+    set_target_properties(${target} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${PROJECT_SOURCE_DIR}/benchmarks/bin)
+    target_link_libraries(${target} ${CMAKE_THREAD_LIBS_INIT})
+endfunction()
@@ -0,0 +1,52 @@
+#include <cvx.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using hires_clock = std::chrono::high_resolution_clock;
+
+// Label a binary PBM or PGM file straight from its memory mapping:
+//
+//   label_file <image.pbm|image.pgm> [connectivity]
+//
+// Black PBM pixels and non-zero PGM pixels are foreground
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Provide the path of a binary PBM or PGM file" << std::endl;
+        return 1;
+    }
+
+    const unsigned char connectivity = static_cast<unsigned char>(argc > 2 ? std::atoi(argv[2]) : 8);
+
+    try {
+        const cvx::mapped_image image(argv[1]);
+        std::vector<std::uint32_t> labels(image.width() * image.height());
+        cvx::array_view<std::uint32_t*> output(labels.data(),
+                                               labels.data() + labels.size(),
+                                               image.width(),
+                                               image.height());
+
+        cvx::labeler<std::uint32_t> labeler(connectivity, cvx::feature_flag::none, cvx::label_engine::run);
+        std::size_t count;
+
+        auto start = hires_clock::now();
+
+        if (image.format() == cvx::image_format::pbm) {
+            count = labeler.label(image.bits(), output, true, false);
+        } else {
+            count = labeler.label(image.view(), output, 1, 0);
+        }
+
+        auto duration = std::chrono::duration<double, std::milli>(hires_clock::now() - start).count();
+
+        std::cout << image.width() << "x" << image.height() << ": found " << count
+                  << " connected components in " << duration << " ms" << std::endl;
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -15,14 +15,30 @@ namespace cvx {
 }
 
 //#include "cvx/algorithms.hpp"
+#include "cvx/batch_labeler.hpp"
+#include "cvx/bit_plane.hpp"
+#include "cvx/bit_view.hpp"
 #include "cvx/ccl.hpp"
 #include "cvx/color.hpp"
+#include "cvx/component_table.hpp"
 #include "cvx/connected_component.hpp"
 #include "cvx/draw.hpp"
 //#include "cvx/ellispe.hpp"
 #include "cvx/exception.hpp"
 #include "cvx/feature_flag.hpp"
+#include "cvx/features.hpp"
+#include "cvx/label_engine.hpp"
+#include "cvx/label_stats.hpp"
+#include "cvx/labeler.hpp"
+#include "cvx/mapped_file.hpp"
+#include "cvx/mapped_image.hpp"
 #include "cvx/point2.hpp"
+#include "cvx/point_runs.hpp"
 #include "cvx/rectangle2.hpp"
+#include "cvx/stream_labeler.hpp"
+#include "cvx/thread_pool.hpp"
+#include "cvx/threshold_view.hpp"
+#include "cvx/tiled_labeler.hpp"
+#include "cvx/trace.hpp"
 
 #endif // CVX_MAIN_HPP
@@ -6,12 +6,30 @@
 #include "cvx/point2.hpp"
 #include "cvx/rectangle2.hpp"
 #include "cvx/utils.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <type_traits>
 
+//////////////////////////////////////////////////////////////////////
+/// The unchecked row access of array_view, which the labelling loops
+/// use, only checks its bounds if CVX_CHECK_BOUNDS is defined (see the
+/// CMake option of the same name), otherwise CVX_ASSERT_BOUNDS expands
+/// to nothing and its condition is never evaluated
+//////////////////////////////////////////////////////////////////////
+#ifdef CVX_CHECK_BOUNDS
+    #define CVX_ASSERT_BOUNDS(condition, message) \
+        do { if (!(condition)) { throw ::cvx::exception(message); } } while (false)
+#else
+    #define CVX_ASSERT_BOUNDS(condition, message) static_cast<void>(0)
+#endif
+
 namespace cvx {
     //////////////////////////////////////////////////////////////////////
-    /// Abstracts a 2D view of an arbitrary range of values
+    /// Abstracts a 2D view of an arbitrary range of values. Rows may be
+    /// further apart than the width of the view, e.g. in buffers whose rows
+    /// are padded for alignment or in a subview of a larger image, in which
+    /// case [begin(), end()[ also spans the padding between the rows
     ///
     /// \param <RandomAccessIterator> Type of the iterator range that is
     ///                               being viewed
@@ -45,7 +63,8 @@ namespace cvx {
                 : first(RandomAccessIterator()),
                   last(RandomAccessIterator()),
                   _width(0),
-                  _height(0) {
+                  _height(0),
+                  _stride(0) {
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -63,7 +82,33 @@ namespace cvx {
                 : first(first),
                   last(last),
                   _width(width),
-                  _height(height) {
+                  _height(height),
+                  _stride(width) {
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Create a view of some data whose rows are stride elements apart
+            ///
+            /// \param first  Iterator to the beginning of the first row
+            /// \param last   Iterator to the end of the last row
+            /// \param width  Width of the data
+            /// \param height Height of the data
+            /// \param stride Number of elements between the beginnings of
+            ///               two rows
+            //////////////////////////////////////////////////////////////////////
+            array_view(RandomAccessIterator first,
+                       RandomAccessIterator last,
+                       size_type width,
+                       size_type height,
+                       size_type stride)
+                : first(first),
+                  last(last),
+                  _width(width),
+                  _height(height),
+                  _stride(stride) {
+                if (stride < width) {
+                    throw exception("Stride is too small for the width");
+                }
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -174,7 +219,7 @@ namespace cvx {
             /// \return The data at (x, y)
             //////////////////////////////////////////////////////////////////////
             reference operator()(size_type y, size_type x) {
-                return *(first + width() * y + x);
+                return *(first + stride() * y + x);
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -185,7 +230,7 @@ namespace cvx {
             /// \return The data at (x, y)
             //////////////////////////////////////////////////////////////////////
             const reference operator()(size_type y, size_type x) const {
-                return *(first + width() * y + x);
+                return *(first + stride() * y + x);
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -221,7 +266,7 @@ namespace cvx {
                     throw exception("Y-coordinate out of bounds");
                 }
 
-                return first + y * width();
+                return first + y * stride();
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -235,7 +280,57 @@ namespace cvx {
                     throw exception("Y-coordinate out of bounds");
                 }
 
-                return first + y * width();
+                return first + y * stride();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Return an iterator to the beginning of the specified row. The
+            /// row is not bounds checked unless CVX_CHECK_BOUNDS is defined
+            ///
+            /// \param y Row to query
+            /// \return Iterator to the first element of the yth row
+            //////////////////////////////////////////////////////////////////////
+            iterator row_begin(size_type y) {
+                CVX_ASSERT_BOUNDS(y < height(), "Y-coordinate out of bounds");
+
+                return first + y * stride();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Return an iterator to the beginning of the specified row. The
+            /// row is not bounds checked unless CVX_CHECK_BOUNDS is defined
+            ///
+            /// \param y Row to query
+            /// \return Iterator to the first element of the yth row
+            //////////////////////////////////////////////////////////////////////
+            const_iterator row_begin(size_type y) const {
+                CVX_ASSERT_BOUNDS(y < height(), "Y-coordinate out of bounds");
+
+                return first + y * stride();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Return an iterator to the end of the specified row, which is
+            /// not the beginning of the next row in a strided view. The row
+            /// is not bounds checked unless CVX_CHECK_BOUNDS is defined
+            ///
+            /// \param y Row to query
+            /// \return Iterator past the last element of the yth row
+            //////////////////////////////////////////////////////////////////////
+            iterator row_end(size_type y) {
+                return row_begin(y) + width();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Return an iterator to the end of the specified row, which is
+            /// not the beginning of the next row in a strided view. The row
+            /// is not bounds checked unless CVX_CHECK_BOUNDS is defined
+            ///
+            /// \param y Row to query
+            /// \return Iterator past the last element of the yth row
+            //////////////////////////////////////////////////////////////////////
+            const_iterator row_end(size_type y) const {
+                return row_begin(y) + width();
             }
 
             //////////////////////////////////////////////////////////////////////
@@ -253,27 +348,54 @@ namespace cvx {
             }
 
             //////////////////////////////////////////////////////////////////////
-            /// \return The stride or pitch of the data viewed as a 2D array
+            /// \return The number of elements between the beginnings of two
+            ///         rows
+            //////////////////////////////////////////////////////////////////////
+            size_type stride() const noexcept {
+                return _stride;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The stride or pitch of the data viewed as a 2D array in
+            ///         bytes
             //////////////////////////////////////////////////////////////////////
             size_type pitch() const noexcept {
-                return _width * sizeof(value_type);
+                return _stride * sizeof(value_type);
             }
 
-            //array_view subview(const rectangle2i& bounds) {
-            //    if (bounds.x < 0 || bounds.y < 0 || bounds.right() >= width || bounds.bottom() >= height) {
-            //       throw std::out_of_range("Subview bounds out of range");
-            //    }
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the rows follow each other without padding, so
+            ///         [begin(), end()[ contains exactly the viewed elements
+            //////////////////////////////////////////////////////////////////////
+            bool contiguous() const noexcept {
+                return _stride == _width || _height <= 1;
+            }
 
-            //    RandomAccessIterator iter = first + bounds.x + stride * bounds.y;
+            //////////////////////////////////////////////////////////////////////
+            /// Create a view of a rectangular region of the data without
+            /// copying it. The subview shares the stride of this view
+            ///
+            /// \param bounds The region to view
+            /// \return A view of the region
+            //////////////////////////////////////////////////////////////////////
+            array_view subview(const rectangle2i& bounds) const {
+                if (bounds.x < 0 || bounds.y < 0 || bounds.width < 0 || bounds.height < 0 ||
+                    static_cast<size_type>(bounds.right()) > width() ||
+                    static_cast<size_type>(bounds.bottom()) > height()) {
+                    throw exception("Subview bounds out of range");
+                }
 
-            //    return array_view(iter,
-            //                     iter + bounds.area(), // Include padding
-            //                     bounds.width,
-            //                     bounds.height,
-            //                     ?);
+                const size_type w = static_cast<size_type>(bounds.width);
+                const size_type h = static_cast<size_type>(bounds.height);
+                RandomAccessIterator iter = first + static_cast<size_type>(bounds.y) * stride() + bounds.x;
 
-            //   return array_view<RandomAccessIterator>();
-            //}
+                // The last row of the region ends before the padding
+                return array_view(iter,
+                                  (h > 0 ? iter + (h - 1) * stride() + w : iter),
+                                  w,
+                                  h,
+                                  stride());
+            }
 
             //////////////////////////////////////////////////////////////////////
             /// \return The total number of elements in the view
@@ -283,7 +405,8 @@ namespace cvx {
             }
 
             //////////////////////////////////////////////////////////////////////
-            /// \return The total number of bytes spanned by the view
+            /// \return The total number of bytes spanned by the rows of the
+            ///         view, including their padding
             //////////////////////////////////////////////////////////////////////
             size_type bytesize() const {
                 return pitch() * _height;
@@ -319,8 +442,68 @@ namespace cvx {
 
         private:
             RandomAccessIterator first, last;
-            size_type _width, _height;
+            size_type _width, _height, _stride;
     };
+
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Apply a function to every run of adjacent elements of a view in
+        /// raster order: the whole of a contiguous view at once, or each row
+        /// of a strided view, skipping the padding between rows
+        ///
+        /// \param view A view of some data
+        /// \param f    Function taking an iterator to the first element of a
+        ///             span and its number of elements
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename Function>
+        void for_each_span(array_view<RandomAccessIterator>& view, Function f) {
+            const std::size_t rows = (view.contiguous() ? std::min<std::size_t>(1, view.height()) : view.height());
+            const std::size_t width = (view.contiguous() ? view.size() : view.width());
+
+            for (std::size_t y = 0; y < rows; ++y) {
+                f(view.row_begin(y), width);
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Apply a function to every element of a view in raster order. The
+        /// padding between the rows of a strided view is skipped, while
+        /// contiguous views are walked in a single loop
+        ///
+        /// \param view A view of some data
+        /// \param f    Function taking a reference to an element
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename Function>
+        void for_each_element(array_view<RandomAccessIterator>& view, Function f) {
+            for_each_span(view, [&f](RandomAccessIterator first, std::size_t count) {
+                for (RandomAccessIterator it = first; it != first + count; ++it) {
+                    f(*it);
+                }
+            });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Transform the elements of a view into another view of the same
+        /// dimensions in raster order, skipping the padding between rows
+        ///
+        /// \param input  A view of some data
+        /// \param output A view to store the transformed elements in
+        /// \param f      Function from an input to an output element
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename OutputIterator, typename Function>
+        void transform_view(const array_view<InputIterator>& input,
+                            array_view<OutputIterator>& output,
+                            Function f) {
+            if (input.contiguous() && output.contiguous()) {
+                std::transform(input.cbegin(), input.cbegin() + input.size(), output.begin(), f);
+                return;
+            }
+
+            for (std::size_t y = 0; y < input.height(); ++y) {
+                std::transform(input.row_begin(y), input.row_end(y), output.row_begin(y), f);
+            }
+        }
+    } // detail
 } // cvx
 
 #endif // CVX_ARRAY_VIEW_HPP
@@ -0,0 +1,161 @@
+#ifndef CVX_BATCH_LABELER_HPP
+#define CVX_BATCH_LABELER_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/connected_component.hpp"
+#include "cvx/export.hpp"
+#include "cvx/feature_flag.hpp"
+#include "cvx/label_engine.hpp"
+#include "cvx/labeler.hpp"
+#include "cvx/thread_pool.hpp"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Labels batches of many small images, e.g. patches, on a thread
+    /// pool. Images are handed out one at a time to whichever thread is
+    /// idle, and every thread labels with its own labeler, so the scratch
+    /// memory of each thread is reused for all images it labels, across
+    /// batches
+    ///
+    /// \param Label Type of the labels written to the label images
+    //////////////////////////////////////////////////////////////////////
+    template<typename Label = int>
+    class CVX_EXPORT batch_labeler final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create a batch labeler
+            ///
+            /// \param pool         Threads to label the images with
+            /// \param connectivity Neighbourhood connectivity (4 or 8)
+            /// \param flags        Bitflag of the component features to
+            ///                     extract
+            /// \param engine       Scan strategy of the two-pass algorithm
+            //////////////////////////////////////////////////////////////////////
+            batch_labeler(thread_pool& pool,
+                          unsigned char connectivity,
+                          const feature_flag& flags = feature_flag::none,
+                          label_engine engine = label_engine::pixel)
+                : pool(pool),
+                  workers(pool.size(), labeler<Label>(connectivity, flags, engine)) {
+            }
+
+            batch_labeler(const batch_labeler&) = delete;
+            batch_labeler& operator=(const batch_labeler&) = delete;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label a batch of images, each into its own label image. The
+            /// inputs and outputs are ranges of array_views, so each image
+            /// can have its own size. The components of each image are kept
+            /// in components()
+            ///
+            /// \param inputs_first  Iterator to the first view of image data
+            /// \param inputs_last   Iterator to the end of the views
+            /// \param outputs_first Iterator to the first view of a label
+            ///                      image, one per input
+            /// \param foreground    Value of foreground elements
+            /// \param background    Value of background elements
+            /// \return The total number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename InputViewIterator, typename OutputViewIterator>
+            std::size_t label(InputViewIterator inputs_first,
+                              InputViewIterator inputs_last,
+                              OutputViewIterator outputs_first,
+                              typename iterator_value_type<InputViewIterator>::value_type foreground,
+                              typename iterator_value_type<InputViewIterator>::value_type background) {
+                return label_batch(inputs_first, inputs_last, outputs_first, foreground, background, [](std::size_t) {});
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label a batch of images, each into its own label image, and
+            /// move the components of each image into its own output
+            /// iterator. components() is left empty
+            ///
+            /// \param inputs_first  Iterator to the first view of image data
+            /// \param inputs_last   Iterator to the end of the views
+            /// \param outputs_first Iterator to the first view of a label
+            ///                      image, one per input
+            /// \param outs_first    Iterator to the first output iterator
+            ///                      for storing connected components, e.g. a
+            ///                      std::back_insert_iterator, one per input
+            /// \param foreground    Value of foreground elements
+            /// \param background    Value of background elements
+            /// \return The total number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename InputViewIterator, typename OutputViewIterator, typename ComponentOutputIterator>
+            std::size_t label(InputViewIterator inputs_first,
+                              InputViewIterator inputs_last,
+                              OutputViewIterator outputs_first,
+                              ComponentOutputIterator outs_first,
+                              typename iterator_value_type<InputViewIterator>::value_type foreground,
+                              typename iterator_value_type<InputViewIterator>::value_type background) {
+                return label_batch(inputs_first, inputs_last, outputs_first, foreground, background, [&](std::size_t i) {
+                    std::vector<connected_component>& components = _components[i];
+
+                    std::move(components.begin(), components.end(), *(outs_first + i));
+                    components.clear();
+                });
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of components in each image of the last
+            ///         batch
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<std::size_t>& counts() const noexcept {
+                return _counts;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The components of each image of the last batch. Empty
+            ///         if no features are extracted
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<std::vector<connected_component>>& components() const noexcept {
+                return _components;
+            }
+
+        private:
+            template<typename InputViewIterator, typename OutputViewIterator, typename Function>
+            std::size_t label_batch(InputViewIterator inputs_first,
+                                    InputViewIterator inputs_last,
+                                    OutputViewIterator outputs_first,
+                                    typename iterator_value_type<InputViewIterator>::value_type foreground,
+                                    typename iterator_value_type<InputViewIterator>::value_type background,
+                                    Function store) {
+                const std::size_t count = static_cast<std::size_t>(std::distance(inputs_first, inputs_last));
+
+                // Resizing keeps the storage of images seen in earlier batches
+                _counts.resize(count);
+                _components.resize(count);
+
+                pool.parallel_for_worker(count, [&](std::size_t i, std::size_t worker) {
+                    labeler<Label>& labeler = workers[worker];
+                    auto& output = *(outputs_first + i);
+
+                    _counts[i] = labeler.label(*(inputs_first + i), output, foreground, background);
+
+                    // The labeler takes the storage of the image's previous
+                    // components in exchange, nothing is copied
+                    labeler.swap_components(_components[i]);
+                    store(i);
+                });
+
+                std::size_t total = 0;
+
+                for (std::size_t n : _counts) {
+                    total += n;
+                }
+
+                return total;
+            }
+
+        private:
+            thread_pool& pool;
+            std::vector<labeler<Label>> workers;
+            std::vector<std::size_t> _counts;
+            std::vector<std::vector<connected_component>> _components;
+    };
+} // cvx
+
+#endif // CVX_BATCH_LABELER_HPP
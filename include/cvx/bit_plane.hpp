@@ -0,0 +1,89 @@
+#ifndef CVX_BIT_PLANE_HPP
+#define CVX_BIT_PLANE_HPP
+
+#include "cvx/export.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// A dense 2D array of bits, e.g. for marking visited elements of an
+    /// image. Resetting it to a new size keeps its storage, so the same
+    /// plane can be reused across calls without reallocating
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT bit_plane final {
+        public:
+            using word_type = std::uint64_t;
+
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create an empty bit plane
+            //////////////////////////////////////////////////////////////////////
+            bit_plane()
+                : _width(0),
+                  _height(0) {
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Create a bit plane with all bits cleared
+            ///
+            /// \param width  Width of the plane
+            /// \param height Height of the plane
+            //////////////////////////////////////////////////////////////////////
+            bit_plane(std::size_t width, std::size_t height)
+                : bit_plane() {
+                reset(width, height);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Resize the plane and clear all bits. Only allocates if the
+            /// plane grows beyond its largest size so far
+            ///
+            /// \param width  Width of the plane
+            /// \param height Height of the plane
+            //////////////////////////////////////////////////////////////////////
+            void reset(std::size_t width, std::size_t height) {
+                _width = width;
+                _height = height;
+                words.assign((width * height + word_bits - 1) / word_bits, 0);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Set the bit at (x, y)
+            //////////////////////////////////////////////////////////////////////
+            void set(std::size_t x, std::size_t y) noexcept {
+                const std::size_t i = y * _width + x;
+                words[i / word_bits] |= word_type(1) << (i % word_bits);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the bit at (x, y) is set
+            //////////////////////////////////////////////////////////////////////
+            bool test(std::size_t x, std::size_t y) const noexcept {
+                const std::size_t i = y * _width + x;
+                return (words[i / word_bits] >> (i % word_bits)) & 1;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The width of the plane
+            //////////////////////////////////////////////////////////////////////
+            std::size_t width() const noexcept {
+                return _width;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The height of the plane
+            //////////////////////////////////////////////////////////////////////
+            std::size_t height() const noexcept {
+                return _height;
+            }
+
+        private:
+            static constexpr std::size_t word_bits = sizeof(word_type) * 8;
+
+            std::size_t _width, _height;
+            std::vector<word_type> words;
+    };
+} // cvx
+
+#endif // CVX_BIT_PLANE_HPP
@@ -0,0 +1,190 @@
+#ifndef CVX_BIT_VIEW_HPP
+#define CVX_BIT_VIEW_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/export.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Order of the pixels within each byte of a packed binary image
+    //////////////////////////////////////////////////////////////////////
+    enum class bit_order : unsigned int {
+        msb_first = 0, /// The first pixel is the most significant bit (PBM)
+        lsb_first = 1  /// The first pixel is the least significant bit
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// A read-only random access iterator over a binary image packed with
+    /// one bit per pixel. Each row starts on a byte boundary and rows are
+    /// stride bytes apart. Dereferencing yields true for set bits
+    ///
+    /// Labelling with label_engine::run finds runs in packed rows a
+    /// machine word at a time, instead of dereferencing every pixel
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT packed_bit_iterator final {
+        public:
+            using value_type        = bool;
+            using reference         = bool;
+            using pointer           = void;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::random_access_iterator_tag;
+
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create a singular iterator
+            //////////////////////////////////////////////////////////////////////
+            packed_bit_iterator()
+                : _data(nullptr),
+                  _width(0),
+                  _stride(0),
+                  _order(bit_order::msb_first),
+                  _index(0) {
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Create an iterator to a pixel of a packed binary image
+            ///
+            /// \param data   Pointer to the first byte of the image
+            /// \param width  Width of the image in pixels
+            /// \param stride Number of bytes between rows
+            /// \param order  Order of the pixels within each byte
+            /// \param index  Index of the pixel in row-major order
+            //////////////////////////////////////////////////////////////////////
+            packed_bit_iterator(const std::uint8_t* data,
+                                std::size_t width,
+                                std::size_t stride,
+                                bit_order order,
+                                difference_type index)
+                : _data(data),
+                  _width(width),
+                  _stride(stride),
+                  _order(order),
+                  _index(index) {
+            }
+
+            reference operator*() const {
+                const std::size_t y = static_cast<std::size_t>(_index) / _width;
+                const std::size_t x = static_cast<std::size_t>(_index) % _width;
+                const std::uint8_t byte = _data[y * _stride + x / 8];
+
+                return (_order == bit_order::msb_first ? (byte >> (7 - x % 8)) : (byte >> (x % 8))) & 1;
+            }
+
+            reference operator[](difference_type n) const {
+                return *(*this + n);
+            }
+
+            packed_bit_iterator& operator++() { ++_index; return *this; }
+            packed_bit_iterator& operator--() { --_index; return *this; }
+            packed_bit_iterator operator++(int) { packed_bit_iterator it(*this); ++_index; return it; }
+            packed_bit_iterator operator--(int) { packed_bit_iterator it(*this); --_index; return it; }
+            packed_bit_iterator& operator+=(difference_type n) { _index += n; return *this; }
+            packed_bit_iterator& operator-=(difference_type n) { _index -= n; return *this; }
+
+            packed_bit_iterator operator+(difference_type n) const {
+                return packed_bit_iterator(_data, _width, _stride, _order, _index + n);
+            }
+
+            packed_bit_iterator operator-(difference_type n) const {
+                return packed_bit_iterator(_data, _width, _stride, _order, _index - n);
+            }
+
+            difference_type operator-(const packed_bit_iterator& other) const { return _index - other._index; }
+
+            bool operator==(const packed_bit_iterator& other) const { return _index == other._index; }
+            bool operator!=(const packed_bit_iterator& other) const { return _index != other._index; }
+            bool operator<(const packed_bit_iterator& other) const  { return _index < other._index; }
+            bool operator>(const packed_bit_iterator& other) const  { return _index > other._index; }
+            bool operator<=(const packed_bit_iterator& other) const { return _index <= other._index; }
+            bool operator>=(const packed_bit_iterator& other) const { return _index >= other._index; }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Pointer to the first byte of the image
+            //////////////////////////////////////////////////////////////////////
+            const std::uint8_t* data() const noexcept {
+                return _data;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Width of the image in pixels
+            //////////////////////////////////////////////////////////////////////
+            std::size_t width() const noexcept {
+                return _width;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Number of bytes between rows
+            //////////////////////////////////////////////////////////////////////
+            std::size_t stride() const noexcept {
+                return _stride;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Order of the pixels within each byte
+            //////////////////////////////////////////////////////////////////////
+            bit_order order() const noexcept {
+                return _order;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Index of the pixel in row-major order
+            //////////////////////////////////////////////////////////////////////
+            difference_type index() const noexcept {
+                return _index;
+            }
+
+        private:
+            const std::uint8_t* _data;
+            std::size_t _width;
+            std::size_t _stride;
+            bit_order _order;
+            difference_type _index;
+    };
+
+    inline packed_bit_iterator operator+(packed_bit_iterator::difference_type n, const packed_bit_iterator& it) {
+        return it + n;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// A view of a binary image packed with one bit per pixel
+    //////////////////////////////////////////////////////////////////////
+    using bit_view = array_view<packed_bit_iterator>;
+
+    //////////////////////////////////////////////////////////////////////
+    /// Create a view of a binary image packed with one bit per pixel
+    ///
+    /// \param data   Pointer to the first byte of the image
+    /// \param width  Width of the image in pixels
+    /// \param height Height of the image in pixels
+    /// \param stride Number of bytes between rows, zero for rows padded
+    ///               to the next byte as in PBM files
+    /// \param order  Order of the pixels within each byte
+    /// \return A view whose iterators can be passed to all labelling
+    ///         functions that write labels to a separate range
+    //////////////////////////////////////////////////////////////////////
+    inline bit_view make_bit_view(const std::uint8_t* data,
+                                  std::size_t width,
+                                  std::size_t height,
+                                  std::size_t stride = 0,
+                                  bit_order order = bit_order::msb_first) {
+        if (!stride) {
+            stride = (width + 7) / 8;
+        }
+
+        if (stride * 8 < width) {
+            throw exception("Stride is too small for the width");
+        }
+
+        using difference_type = packed_bit_iterator::difference_type;
+
+        return bit_view(packed_bit_iterator(data, width, stride, order, 0),
+                        packed_bit_iterator(data, width, stride, order, static_cast<difference_type>(width * height)),
+                        width,
+                        height);
+    }
+} // cvx
+
+#endif // CVX_BIT_VIEW_HPP
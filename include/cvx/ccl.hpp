@@ -1,8 +1,14 @@
 #ifndef CVX_LABEL_CONNECTED_COMPONENTS_HPP
 #define CVX_LABEL_CONNECTED_COMPONENTS_HPP
 
+#include "cvx/bit_plane.hpp"
+#include "cvx/component_table.hpp"
 #include "cvx/export.hpp"
 #include "cvx/feature_flag.hpp"
+#include "cvx/features.hpp"
+#include "cvx/label_engine.hpp"
+#include "cvx/thread_pool.hpp"
+#include "cvx/threshold_view.hpp"
 #include "cvx/detail/ccl.hpp" // See for 'iterator_value_type'
 
 namespace cvx {
@@ -19,6 +25,7 @@ namespace cvx {
     /// \param connectivity         Neighbourhood connectivity (4 or 8)
     /// \param foreground           Value of foreground elements
     /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
     /// \return The number of connected components found
     //////////////////////////////////////////////////////////////////////
     template<typename RandomAccessIterator>
@@ -28,14 +35,53 @@ namespace cvx {
                                                       std::size_t height,
                                                       unsigned char connectivity,
                                                       iterator_value_type<RandomAccessIterator> foreground,
-                                                      iterator_value_type<RandomAccessIterator> background) {
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
         return detail::label_connected_components(first,
                                                   last,
                                                   width,
                                                   height,
                                                   connectivity,
                                                   foreground,
-                                                  background);
+                                                  background,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some binary image data
+    /// given by the iterator range [first, last[ using multiple threads
+    ///
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param pool                 Threads to label the image data with.
+    ///                             The image is split into one horizontal
+    ///                             strip per thread
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename RandomAccessIterator>
+    CVX_EXPORT std::size_t label_connected_components(RandomAccessIterator first,
+                                                      RandomAccessIterator last,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      thread_pool& pool) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  pool);
     }
 
     //////////////////////////////////////////////////////////////////////
@@ -56,6 +102,55 @@ namespace cvx {
     /// \param background           Value of background elements
     /// \param flags                Bitflag of the component features to
     ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename RandomAccessIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(RandomAccessIterator first,
+                                                      RandomAccessIterator last,
+                                                      OutputIterator out,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      const feature_flag& flags = feature_flag::none,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  out,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  flags,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some binary image data given by
+    /// the iterator range [first, last[ and extract features, reusing a
+    /// scratch bit plane for marking traced contour points. Passing the
+    /// same plane to repeated calls avoids reallocating it per image
+    ///
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param OutputIterator       Output iterator type for components
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \param visited              Scratch bit plane for contour tracing
     /// \return The number of connected components found
     //////////////////////////////////////////////////////////////////////
     template<typename RandomAccessIterator,
@@ -68,16 +163,714 @@ namespace cvx {
                                                       unsigned char connectivity,
                                                       iterator_value_type<RandomAccessIterator> foreground,
                                                       iterator_value_type<RandomAccessIterator> background,
-                                                      const feature_flag& flags = feature_flag::none) {
+                                                      const feature_flag& flags,
+                                                      label_engine engine,
+                                                      bit_plane& visited) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  out,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  flags,
+                                                  engine,
+                                                  visited);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some constant binary image data
+    /// given by the iterator range [first, last[ into the separate label
+    /// image [labels_first, labels_last[. The input is left untouched and
+    /// can be of any element type, e.g. an 8-bit mask, while the labels
+    /// have the element type of the label image
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator, typename LabelIterator>
+    CVX_EXPORT std::size_t label_connected_components(InputIterator first,
+                                                      InputIterator last,
+                                                      LabelIterator labels_first,
+                                                      LabelIterator labels_last,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  labels_first,
+                                                  labels_last,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some constant binary image data
+    /// given by the iterator range [first, last[ into the separate label
+    /// image [labels_first, labels_last[ using multiple threads
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param pool                 Threads to label the image data with
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator, typename LabelIterator>
+    CVX_EXPORT std::size_t label_connected_components(InputIterator first,
+                                                      InputIterator last,
+                                                      LabelIterator labels_first,
+                                                      LabelIterator labels_last,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      thread_pool& pool) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  labels_first,
+                                                  labels_last,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  pool);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some constant binary image data
+    /// given by the iterator range [first, last[ into the separate label
+    /// image [labels_first, labels_last[ and extract features
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param OutputIterator       Output iterator type for components
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator,
+             typename LabelIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(InputIterator first,
+                                                      InputIterator last,
+                                                      LabelIterator labels_first,
+                                                      LabelIterator labels_last,
+                                                      OutputIterator out,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      const feature_flag& flags = feature_flag::none,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  labels_first,
+                                                  labels_last,
+                                                  out,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  flags,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some binary image data given by
+    /// the iterator range [first, last[ and extract a static set of
+    /// features, e.g.
+    ///
+    ///     label_connected_components<features<area, bounding_box>>(...)
+    ///
+    /// The feature policies are composed at compile-time, so their
+    /// per-element updates are inlined into the labelling loop instead of
+    /// being virtual calls
+    ///
+    /// \param Features             A cvx::features<...> type
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param OutputIterator       Output iterator type for components
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename Features,
+             typename RandomAccessIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(RandomAccessIterator first,
+                                                      RandomAccessIterator last,
+                                                      OutputIterator out,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  out,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  Features(),
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some constant binary image data
+    /// given by the iterator range [first, last[ into the separate label
+    /// image [labels_first, labels_last[ and extract a static set of
+    /// features
+    ///
+    /// \param Features             A cvx::features<...> type
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param OutputIterator       Output iterator type for components
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename Features,
+             typename InputIterator,
+             typename LabelIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(InputIterator first,
+                                                      InputIterator last,
+                                                      LabelIterator labels_first,
+                                                      LabelIterator labels_last,
+                                                      OutputIterator out,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
         return detail::label_connected_components(first,
                                                   last,
+                                                  labels_first,
+                                                  labels_last,
                                                   out,
                                                   width,
                                                   height,
                                                   connectivity,
                                                   foreground,
                                                   background,
-                                                  flags);
+                                                  Features(),
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some binary image data given by
+    /// the iterator range [first, last[ and extract the area, centroid and
+    /// bounding box of each component into a component table, which
+    /// stores each feature in its own contiguous array
+    ///
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param table                Receives the features of all components
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename RandomAccessIterator>
+    CVX_EXPORT std::size_t label_connected_components(RandomAccessIterator first,
+                                                      RandomAccessIterator last,
+                                                      component_table& table,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  table,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components in some constant binary image data
+    /// given by the iterator range [first, last[ into the separate label
+    /// image [labels_first, labels_last[ and extract the area, centroid
+    /// and bounding box of each component into a component table
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param table                Receives the features of all components
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator, typename LabelIterator>
+    CVX_EXPORT std::size_t label_connected_components(InputIterator first,
+                                                      InputIterator last,
+                                                      LabelIterator labels_first,
+                                                      LabelIterator labels_last,
+                                                      component_table& table,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        return detail::label_connected_components(first,
+                                                  last,
+                                                  labels_first,
+                                                  labels_last,
+                                                  table,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  foreground,
+                                                  background,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the elements in the iterator
+    /// range [first, last[ for which a predicate holds, e.g. the pixels of
+    /// a grayscale image above a threshold, into the separate label image
+    /// [labels_first, labels_last[. Elements are classified while they
+    /// are scanned, so no thresholded copy of the image is made
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param UnaryPredicate       Predicate type on the element type
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param pred                 Unary predicate that identifies
+    ///                             foreground elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator,
+             typename LabelIterator,
+             typename UnaryPredicate>
+    CVX_EXPORT std::size_t label_connected_components_if(InputIterator first,
+                                                         InputIterator last,
+                                                         LabelIterator labels_first,
+                                                         LabelIterator labels_last,
+                                                         std::size_t width,
+                                                         std::size_t height,
+                                                         unsigned char connectivity,
+                                                         UnaryPredicate pred,
+                                                         label_engine engine = label_engine::pixel) {
+        const auto input = make_threshold_view(first, last, width, height, pred);
+
+        return detail::label_connected_components(input.cbegin(),
+                                                  input.cend(),
+                                                  labels_first,
+                                                  labels_last,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  true,
+                                                  false,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the elements in the iterator
+    /// range [first, last[ for which a predicate holds into the separate
+    /// label image [labels_first, labels_last[ and extract features.
+    /// Elements are classified while they are scanned, so no thresholded
+    /// copy of the image is made
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param OutputIterator       Output iterator type for components
+    /// \param UnaryPredicate       Predicate type on the element type
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param pred                 Unary predicate that identifies
+    ///                             foreground elements
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator,
+             typename LabelIterator,
+             typename OutputIterator,
+             typename UnaryPredicate>
+    CVX_EXPORT std::size_t label_connected_components_if(InputIterator first,
+                                                         InputIterator last,
+                                                         LabelIterator labels_first,
+                                                         LabelIterator labels_last,
+                                                         OutputIterator out,
+                                                         std::size_t width,
+                                                         std::size_t height,
+                                                         unsigned char connectivity,
+                                                         UnaryPredicate pred,
+                                                         const feature_flag& flags = feature_flag::none,
+                                                         label_engine engine = label_engine::pixel) {
+        const auto input = make_threshold_view(first, last, width, height, pred);
+
+        return detail::label_connected_components(input.cbegin(),
+                                                  input.cend(),
+                                                  labels_first,
+                                                  labels_last,
+                                                  out,
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  true,
+                                                  false,
+                                                  flags,
+                                                  engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the elements in the iterator
+    /// range [first, last[ with values in [lo, hi] into the separate label
+    /// image [labels_first, labels_last[, without thresholding the image
+    /// first
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param lo                   Smallest foreground value
+    /// \param hi                   Largest foreground value
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator, typename LabelIterator>
+    CVX_EXPORT std::size_t label_connected_components_in_range(InputIterator first,
+                                                               InputIterator last,
+                                                               LabelIterator labels_first,
+                                                               LabelIterator labels_last,
+                                                               std::size_t width,
+                                                               std::size_t height,
+                                                               unsigned char connectivity,
+                                                               iterator_value_type<InputIterator> lo,
+                                                               iterator_value_type<InputIterator> hi,
+                                                               label_engine engine = label_engine::pixel) {
+        return label_connected_components_if(first,
+                                             last,
+                                             labels_first,
+                                             labels_last,
+                                             width,
+                                             height,
+                                             connectivity,
+                                             in_range<iterator_value_type<InputIterator>>{ lo, hi },
+                                             engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the elements in the iterator
+    /// range [first, last[ with values in [lo, hi] into the separate label
+    /// image [labels_first, labels_last[ and extract features, without
+    /// thresholding the image first
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param OutputIterator       Output iterator type for components
+    /// \param first                Iterator to the beginning of the image
+    ///                             data
+    /// \param last                 Iterator to the end of the image data
+    /// \param labels_first         Iterator to the beginning of the label
+    ///                             image
+    /// \param labels_last          Iterator to the end of the label image
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param width                Width of the image data
+    /// \param height               Height of the image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param lo                   Smallest foreground value
+    /// \param hi                   Largest foreground value
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator,
+             typename LabelIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components_in_range(InputIterator first,
+                                                               InputIterator last,
+                                                               LabelIterator labels_first,
+                                                               LabelIterator labels_last,
+                                                               OutputIterator out,
+                                                               std::size_t width,
+                                                               std::size_t height,
+                                                               unsigned char connectivity,
+                                                               iterator_value_type<InputIterator> lo,
+                                                               iterator_value_type<InputIterator> hi,
+                                                               const feature_flag& flags = feature_flag::none,
+                                                               label_engine engine = label_engine::pixel) {
+        return label_connected_components_if(first,
+                                             last,
+                                             labels_first,
+                                             labels_last,
+                                             out,
+                                             width,
+                                             height,
+                                             connectivity,
+                                             in_range<iterator_value_type<InputIterator>>{ lo, hi },
+                                             flags,
+                                             engine);
+    }
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the binary image data given by
+    /// a view in place. The view may be strided or a subview of a larger
+    /// image, e.g. a region of interest, in which case only the elements
+    /// inside the view are read and written
+    ///
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param view                 The view of some image data
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename RandomAccessIterator>
+    CVX_EXPORT std::size_t label_connected_components(array_view<RandomAccessIterator>& view,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        detail::validate_arguments(connectivity, foreground, background);
+
+        return detail::two_pass_label(view, view, connectivity, background, engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the binary image data given by
+    /// a view in place and extract features. The view may be strided or a
+    /// subview of a larger image. Coordinates of the features are
+    /// relative to the view
+    ///
+    /// \param RandomAccessIterator Iterator type providing random access
+    /// \param OutputIterator       Output iterator type for components
+    /// \param view                 The view of some image data
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename RandomAccessIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(array_view<RandomAccessIterator>& view,
+                                                      OutputIterator out,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<RandomAccessIterator> foreground,
+                                                      iterator_value_type<RandomAccessIterator> background,
+                                                      const feature_flag& flags,
+                                                      label_engine engine = label_engine::pixel) {
+        detail::validate_arguments(connectivity, foreground, background);
+
+        if (!any_flags(flags)) {
+            return detail::two_pass_label(view, view, connectivity, background, engine);
+        }
+
+        bit_plane visited;
+
+        return detail::label_connected_components_view(view,
+                                                       out,
+                                                       connectivity,
+                                                       background,
+                                                       flags,
+                                                       engine,
+                                                       visited);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the constant binary image data
+    /// given by a view into a separate label image of the same
+    /// dimensions. Either view may be strided or a subview of a larger
+    /// image, so a region of interest of a frame can be labelled without
+    /// copying it out first
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param input                The view of some image data
+    /// \param output               The view of the label image
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator, typename LabelIterator>
+    CVX_EXPORT std::size_t label_connected_components(const array_view<InputIterator>& input,
+                                                      array_view<LabelIterator>& output,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      label_engine engine = label_engine::pixel) {
+        detail::validate_arguments(input, output, connectivity, foreground, background);
+
+        return detail::two_pass_label(input, output, connectivity, background, engine);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Label the connected components of the constant binary image data
+    /// given by a view into a separate label image of the same dimensions
+    /// and extract features. Either view may be strided or a subview of a
+    /// larger image. Coordinates of the features are relative to the
+    /// views
+    ///
+    /// \param InputIterator        Iterator type of the image data
+    /// \param LabelIterator        Iterator type of the label image
+    /// \param OutputIterator       Output iterator type for components
+    /// \param input                The view of some image data
+    /// \param output               The view of the label image
+    /// \param out                  Output iterator for storing connected
+    ///                             components, e.g. a std::vector
+    /// \param connectivity         Neighbourhood connectivity (4 or 8)
+    /// \param foreground           Value of foreground elements
+    /// \param background           Value of background elements
+    /// \param flags                Bitflag of the component features to
+    ///                             extract
+    /// \param engine               Scan strategy of the labelling algorithm
+    /// \return The number of connected components found
+    //////////////////////////////////////////////////////////////////////
+    template<typename InputIterator,
+             typename LabelIterator,
+             typename OutputIterator>
+    CVX_EXPORT std::size_t label_connected_components(const array_view<InputIterator>& input,
+                                                      array_view<LabelIterator>& output,
+                                                      OutputIterator out,
+                                                      unsigned char connectivity,
+                                                      iterator_value_type<InputIterator> foreground,
+                                                      iterator_value_type<InputIterator> background,
+                                                      const feature_flag& flags,
+                                                      label_engine engine = label_engine::pixel) {
+        detail::validate_arguments(input, output, connectivity, foreground, background);
+
+        if (!any_flags(flags)) {
+            return detail::two_pass_label(input, output, connectivity, background, engine);
+        }
+
+        return detail::label_connected_components_view(input,
+                                                       output,
+                                                       out,
+                                                       connectivity,
+                                                       background,
+                                                       flags,
+                                                       engine);
     }
 } // cvx
 
@@ -0,0 +1,239 @@
+#ifndef CVX_COMPONENT_TABLE_HPP
+#define CVX_COMPONENT_TABLE_HPP
+
+#include "cvx/export.hpp"
+#include "cvx/features.hpp"
+#include "cvx/point2.hpp"
+#include "cvx/rectangle2.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace cvx {
+    namespace detail {
+        struct table_features;
+    } // detail
+
+    //////////////////////////////////////////////////////////////////////
+    /// The area, centroid and bounding box of all connected components of
+    /// an image, stored as one contiguous array per feature instead of one
+    /// connected_component per component. Element i of every array
+    /// belongs to the component with label i + 1
+    ///
+    /// Labelling into a table extracts the features directly into the
+    /// arrays, so filtering or sorting components by a feature only
+    /// touches that feature, and millions of components fit in memory.
+    /// Clearing the table keeps its storage for the next image
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT component_table final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of components in the table
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept {
+                return _areas.size();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the table has no components
+            //////////////////////////////////////////////////////////////////////
+            bool empty() const noexcept {
+                return _areas.empty();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Remove all components but keep the allocated storage
+            //////////////////////////////////////////////////////////////////////
+            void clear() noexcept {
+                resize(0);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param i Index of the component
+            /// \return The label of the component
+            //////////////////////////////////////////////////////////////////////
+            std::size_t label(std::size_t i) const noexcept {
+                return i + 1;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param i Index of the component
+            /// \return The number of elements of the component
+            //////////////////////////////////////////////////////////////////////
+            std::size_t area(std::size_t i) const {
+                return _areas[i];
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param i Index of the component
+            /// \return The centroid of the component
+            //////////////////////////////////////////////////////////////////////
+            point2f centroid(std::size_t i) const {
+                return point2f(static_cast<float>(_centroids_x[i]), static_cast<float>(_centroids_y[i]));
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param i Index of the component
+            /// \return The bounding box of the component
+            //////////////////////////////////////////////////////////////////////
+            rectangle2i bounding_box(std::size_t i) const {
+                return rectangle2i(_min_x[i],
+                                   _min_y[i],
+                                   _max_x[i] - _min_x[i] + 1,
+                                   _max_y[i] - _min_y[i] + 1);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The areas of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<std::size_t>& areas() const noexcept {
+                return _areas;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The x-coordinates of the centroids of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<double>& centroids_x() const noexcept {
+                return _centroids_x;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The y-coordinates of the centroids of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<double>& centroids_y() const noexcept {
+                return _centroids_y;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The smallest x-coordinates of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<int>& min_x() const noexcept {
+                return _min_x;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The smallest y-coordinates of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<int>& min_y() const noexcept {
+                return _min_y;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The largest x-coordinates of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<int>& max_x() const noexcept {
+                return _max_x;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The largest y-coordinates of all components
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<int>& max_y() const noexcept {
+                return _max_y;
+            }
+
+        private:
+            friend struct detail::table_features;
+
+            void resize(std::size_t count) {
+                // assign() only reallocates if count exceeds the capacity
+                _areas.assign(count, 0);
+                _centroids_x.assign(count, 0.0);
+                _centroids_y.assign(count, 0.0);
+                _min_x.assign(count, std::numeric_limits<int>::max());
+                _min_y.assign(count, std::numeric_limits<int>::max());
+                _max_x.assign(count, -1);
+                _max_y.assign(count, -1);
+            }
+
+        private:
+            std::vector<std::size_t> _areas;
+            std::vector<double> _centroids_x;
+            std::vector<double> _centroids_y;
+            std::vector<int> _min_x;
+            std::vector<int> _min_y;
+            std::vector<int> _max_x;
+            std::vector<int> _max_y;
+    };
+
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// A component of a component_table, as passed to the features by
+        /// the relabelling functions
+        //////////////////////////////////////////////////////////////////////
+        struct table_row {
+            component_table& table;
+            std::size_t index;
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// Stands in for the vector of connected components in the
+        /// relabelling functions, so components[label - 1] refers to a row
+        /// of the table
+        //////////////////////////////////////////////////////////////////////
+        struct table_rows {
+            component_table& table;
+
+            table_row operator[](std::size_t i) const {
+                return table_row{ table, i };
+            }
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// Feature set that accumulates the area, centroid and bounding box
+        /// of each element into the arrays of a component_table
+        //////////////////////////////////////////////////////////////////////
+        struct table_features {
+            //////////////////////////////////////////////////////////////////////
+            /// Make room for count components with empty features
+            //////////////////////////////////////////////////////////////////////
+            static void initialise(component_table& table, std::size_t count) {
+                table.resize(count);
+            }
+
+            void update(std::size_t x, std::size_t y, table_row row) const {
+                component_table& table = row.table;
+                const std::size_t i = row.index;
+                const int xi = static_cast<int>(x);
+                const int yi = static_cast<int>(y);
+
+                ++table._areas[i];
+                table._centroids_x[i] += xi;
+                table._centroids_y[i] += yi;
+                table._min_x[i] = std::min(table._min_x[i], xi);
+                table._min_y[i] = std::min(table._min_y[i], yi);
+                table._max_x[i] = std::max(table._max_x[i], xi);
+                table._max_y[i] = std::max(table._max_y[i], yi);
+            }
+
+            void update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, table_row row) const {
+                component_table& table = row.table;
+                const std::size_t i = row.index;
+                const std::size_t length = x_end - x_begin;
+
+                table._areas[i] += length;
+                table._centroids_x[i] += detail::run_coordinate_sum(x_begin, x_end);
+                table._centroids_y[i] += static_cast<double>(length) * static_cast<double>(y);
+                table._min_x[i] = std::min(table._min_x[i], static_cast<int>(x_begin));
+                table._min_y[i] = std::min(table._min_y[i], static_cast<int>(y));
+                table._max_x[i] = std::max(table._max_x[i], static_cast<int>(x_end) - 1);
+                table._max_y[i] = std::max(table._max_y[i], static_cast<int>(y));
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Turn the accumulated coordinates into centroids
+            //////////////////////////////////////////////////////////////////////
+            static void finalise(component_table& table) {
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    const double area = static_cast<double>(table._areas[i]);
+
+                    table._centroids_x[i] /= area;
+                    table._centroids_y[i] /= area;
+                }
+            }
+        };
+    } // detail
+} // cvx
+
+#endif // CVX_COMPONENT_TABLE_HPP
@@ -0,0 +1,209 @@
+#ifndef CVX_CONCURRENT_UNION_FIND_HPP
+#define CVX_CONCURRENT_UNION_FIND_HPP
+
+#include "cvx/export.hpp"
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// A lock-free disjoint set data structure for integral types that
+    /// can be shared by multiple threads. The implementation follows
+    /// "Wait-free parallel algorithms for the union-find problem" by
+    /// Richard J. Anderson and Heather Woll: roots are linked with a
+    /// compare-and-swap and finds do path halving.
+    ///
+    /// Larger roots are always linked below smaller roots, so the root of
+    /// each set is its smallest label, exactly as in cvx::union_find. This
+    /// makes the flattened labels independent of the order in which
+    /// threads merged them.
+    ///
+    /// The number of labels is fixed at construction. merge(), find() and
+    /// root() may be called concurrently, flatten() and get() may not
+    //////////////////////////////////////////////////////////////////////
+    template<typename T>
+    class CVX_EXPORT concurrent_union_find final {
+        // Ensure that T is an integral type
+        static_assert(std::is_integral<T>::value, "T must be an integral type");
+
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Construct a concurrent union-find where every label in
+            /// [0, size[ is its own root
+            ///
+            /// \param size Number of labels
+            //////////////////////////////////////////////////////////////////////
+            explicit concurrent_union_find(std::size_t size)
+                : _label_count(0),
+                  labels(size) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    labels[i].store(static_cast<T>(i), std::memory_order_relaxed);
+                }
+            }
+
+            concurrent_union_find(const concurrent_union_find&) = delete;
+            concurrent_union_find& operator=(const concurrent_union_find&) = delete;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Returns the root currently pointed to by a label without
+            /// modifying the structure. Wait-free
+            ///
+            /// \param label Query label
+            /// \return Root of the label
+            //////////////////////////////////////////////////////////////////////
+            T root(T label) const {
+                T parent = labels[label].load(std::memory_order_acquire);
+
+                while (parent != label) {
+                    label = parent;
+                    parent = labels[label].load(std::memory_order_acquire);
+                }
+
+                return label;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Returns the root of a label and halves the path to it
+            ///
+            /// \param label Query label
+            /// \return Root of the label
+            //////////////////////////////////////////////////////////////////////
+            T find(T label) {
+                while (true) {
+                    T parent = labels[label].load(std::memory_order_acquire);
+
+                    if (parent == label) {
+                        return label;
+                    }
+
+                    T grandparent = labels[parent].load(std::memory_order_acquire);
+
+                    if (parent != grandparent) {
+                        // Failing is harmless, another thread moved the label
+                        // closer to its root already
+                        labels[label].compare_exchange_weak(parent,
+                                                            grandparent,
+                                                            std::memory_order_acq_rel,
+                                                            std::memory_order_acquire);
+                    }
+
+                    label = grandparent;
+                }
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Merge the sets of label1 and label2
+            ///
+            /// \param label1 First label
+            /// \param label2 Second label
+            /// \return The common root of label1 and label2 at the time they
+            ///         were merged
+            //////////////////////////////////////////////////////////////////////
+            T merge(T label1, T label2) {
+                while (true) {
+                    T root1 = find(label1);
+                    T root2 = find(label2);
+
+                    if (root1 == root2) {
+                        return root1;
+                    }
+
+                    if (root1 > root2) {
+                        std::swap(root1, root2);
+                    }
+
+                    // Link the larger root below the smaller one, but only if
+                    // it is still a root. Otherwise retry from the new roots
+                    T expected = root2;
+
+                    if (labels[root2].compare_exchange_strong(expected,
+                                                              root1,
+                                                              std::memory_order_acq_rel,
+                                                              std::memory_order_acquire)) {
+                        return root1;
+                    }
+
+                    label1 = root1;
+                    label2 = expected;
+                }
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the two labels are in the same set
+            //////////////////////////////////////////////////////////////////////
+            bool same(T label1, T label2) {
+                while (true) {
+                    T root1 = find(label1);
+                    T root2 = find(label2);
+
+                    if (root1 == root2) {
+                        return true;
+                    }
+
+                    // If root1 is still a root, the labels were in different
+                    // sets when root2 was found
+                    if (labels[root1].load(std::memory_order_acquire) == root1) {
+                        return false;
+                    }
+
+                    label1 = root1;
+                    label2 = root2;
+                }
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Ensure that all labels point to their roots, that roots have
+            /// consecutive labels and compute the number of unique labels.
+            /// Label 0 is reserved for the background
+            //////////////////////////////////////////////////////////////////////
+            void flatten() {
+                // Counted wider than T, there may be as many roots as T's
+                // largest value
+                std::size_t k = 1;
+
+                for (std::size_t i = 1; i < labels.size(); ++i) {
+                    const T parent = labels[i].load(std::memory_order_relaxed);
+
+                    if (static_cast<std::size_t>(parent) < i) {
+                        labels[i].store(labels[parent].load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+                    } else {
+                        labels[i].store(static_cast<T>(k++), std::memory_order_relaxed);
+                    }
+                }
+
+                _label_count = k - 1;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param i The label to query
+            /// \return The current parent of label i, i.e. its final label
+            ///         after flatten()
+            //////////////////////////////////////////////////////////////////////
+            T get(std::size_t i) const {
+                return labels[i].load(std::memory_order_relaxed);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The size of the union-find
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept {
+                return labels.size();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of unique labels after flatten()
+            //////////////////////////////////////////////////////////////////////
+            std::size_t label_count() const noexcept {
+                return _label_count;
+            }
+
+        private:
+            std::size_t _label_count;
+            std::vector<std::atomic<T>> labels;
+    };
+} // cvx
+
+#endif // CVX_CONCURRENT_UNION_FIND_HPP
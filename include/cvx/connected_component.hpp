@@ -5,6 +5,7 @@
 #include "cvx/color.hpp"
 #include "cvx/export.hpp"
 #include "cvx/point2.hpp"
+#include "cvx/point_runs.hpp"
 #include "cvx/rectangle2.hpp"
 #include <algorithm>
 #include <limits>
@@ -23,6 +24,7 @@ namespace cvx {
         class extent_extractor;
         class point_extractor;
         class bounding_box_extractor;
+        struct component_access;
 
         template<typename RandomAccessIterator,
                  typename AssociativeContainer>
@@ -60,6 +62,7 @@ namespace cvx {
         friend class detail::extent_extractor;
         friend class detail::point_extractor;
         friend class detail::bounding_box_extractor;
+        friend struct detail::component_access;
 
         template<typename RandomAccessIterator,
                  typename AssociativeContainer>
@@ -105,7 +108,8 @@ namespace cvx {
             color fill_color() const;
 
             //////////////////////////////////////////////////////////////////////
-            /// Query if a given point is part of the component
+            /// Query if a given point is part of the component. With the point
+            /// set extracted this is a binary search over its runs
             ///
             /// \param p The query point
             /// \return True if the point is part of the component, false
@@ -163,10 +167,18 @@ namespace cvx {
             }
 
             //////////////////////////////////////////////////////////////////////
-            /// \return The points that the blob consists of
+            /// \return The points that the blob consists of. The points are
+            ///         expanded from runs() on first use, so prefer runs()
+            ///         for large components
             //////////////////////////////////////////////////////////////////////
             const std::vector<point2i>& points() const;
 
+            //////////////////////////////////////////////////////////////////////
+            /// \return The points that the blob consists of as horizontal
+            ///         runs in raster order
+            //////////////////////////////////////////////////////////////////////
+            const point_runs& runs() const noexcept;
+
             //////////////////////////////////////////////////////////////////////
             /// \return The outer contour of the blob
             //////////////////////////////////////////////////////////////////////
@@ -339,6 +351,7 @@ namespace cvx {
             color _color;
             mutable std::size_t _area;
             mutable point2f _centroid;
+            point_runs _runs;
             mutable std::vector<point2i> _points;
             mutable std::vector<point2i> _contour;
             mutable std::vector<std::vector<point2i>> _inner_contours;
@@ -9,6 +9,7 @@ namespace cvx {
             public:
                 void initialise(connected_component& component) override;
                 void update(std::size_t x, std::size_t y, connected_component& component) override;
+                void update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) override;
                 void finalise(connected_component& component) override;
         };
     } // detail
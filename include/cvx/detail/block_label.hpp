@@ -0,0 +1,241 @@
+#ifndef CVX_BLOCK_LABEL_HPP
+#define CVX_BLOCK_LABEL_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/connected_component.hpp"
+#include "cvx/exception.hpp"
+#include "cvx/union_find.hpp"
+#include "cvx/utils.hpp"
+#include <iterator>
+#include <vector>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Scan labels using 8-connectivity on 2x2 blocks of elements. This
+        /// is based on "Optimized Block-Based Connected Components Labeling
+        /// With Decision Trees" by Costantino Grana, Daniele Borghesani and
+        /// Rita Cucchiara.
+        ///
+        /// All foreground elements of a 2x2 block are 8-connected, so each
+        /// block only needs a single provisional label and only has to
+        /// examine the blocks P, Q, R and S of its neighbourhood:
+        ///
+        ///   +---+---+---+
+        ///   | P | Q | R |     h | i j | k
+        ///   +---+---+---+     --+-----+--
+        ///   | S | X |         n | o p
+        ///   +---+---+         r | s t
+        ///
+        /// Only the elements h, i, j, k, n and r of the neighbouring blocks
+        /// can be adjacent to the current block X. Since those have already
+        /// been labelled, a non-zero label means they are foreground and
+        /// carry the label of their block.
+        ///
+        /// \param input      A view of some image data
+        /// \param output     A view of the label image, may be the same as
+        ///                   input
+        /// \param labels     Label equivalences
+        /// \param background Value of background elements
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        void scan_blocks8(const array_view<InputIterator>& input,
+                          array_view<LabelIterator>& output,
+                          union_find<iterator_value_type<LabelIterator>>& labels,
+                          iterator_value_type<InputIterator> background) {
+            using U = iterator_value_type<LabelIterator>;
+            const std::size_t width = input.width();
+            const std::size_t height = input.height();
+
+            for (std::size_t y = 0; y < height; y += 2) {
+                const bool has_below = (y + 1 < height);
+
+                for (std::size_t x = 0; x < width; x += 2) {
+                    const bool has_right = (x + 1 < width);
+
+                    // Read the whole block before writing any labels, so the
+                    // input can be labelled in place
+                    const bool fo = input(y, x) != background;
+                    const bool fp = has_right && input(y, x + 1) != background;
+                    const bool fs = has_below && input(y + 1, x) != background;
+                    const bool ft = has_right && has_below && input(y + 1, x + 1) != background;
+
+                    U label = 0;
+
+                    if (fo || fp || fs || ft) {
+                        U h = 0, i = 0, j = 0, k = 0, n = 0, r = 0;
+
+                        if (y > 0) {
+                            i = output(y - 1, x);
+
+                            if (has_right) {
+                                j = output(y - 1, x + 1);
+                            }
+
+                            if (x > 0) {
+                                h = output(y - 1, x - 1);
+                            }
+
+                            if (x + 2 < width) {
+                                k = output(y - 1, x + 2);
+                            }
+                        }
+
+                        if (x > 0) {
+                            n = output(y, x - 1);
+
+                            if (has_below) {
+                                r = output(y + 1, x - 1);
+                            }
+                        }
+
+                        // Labels of the neighbouring blocks that are connected to X
+                        const U q = ((fo || fp) && (i || j)) ? (i ? i : j) : 0;
+                        const U p = (fo && h) ? h : 0;
+                        const U s = ((fo || fs) && (n || r)) ? (n ? n : r) : 0;
+                        const U rr = (fp && k) ? k : 0;
+
+                        // Skip merges of blocks that are already known to be
+                        // equivalent because their adjacent elements touch
+                        if (q) {
+                            label = q;
+
+                            if (p && !i) {
+                                label = labels.merge(label, p);
+                            }
+
+                            if (rr && !j) {
+                                label = labels.merge(label, rr);
+                            }
+
+                            if (s && !(n && (i || p))) {
+                                label = labels.merge(label, s);
+                            }
+                        } else if (p) {
+                            label = p;
+
+                            if (rr) {
+                                label = labels.merge(label, rr);
+                            }
+
+                            if (s && !n) {
+                                label = labels.merge(label, s);
+                            }
+                        } else if (rr) {
+                            label = rr;
+
+                            if (s) {
+                                label = labels.merge(label, s);
+                            }
+                        } else if (s) {
+                            label = s;
+                        } else {
+                            label = labels.new_label();
+                        }
+                    }
+
+                    output(y, x) = fo ? label : 0;
+
+                    if (has_right) {
+                        output(y, x + 1) = fp ? label : 0;
+                    }
+
+                    if (has_below) {
+                        output(y + 1, x) = fs ? label : 0;
+
+                        if (has_right) {
+                            output(y + 1, x + 1) = ft ? label : 0;
+                        }
+                    }
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Relabel all connected components found by scan_blocks8.
+        ///
+        /// Blocks are visited two rows at a time, so the provisional roots
+        /// are not necessarily in raster order. Final labels are therefore
+        /// assigned in the order that components are first encountered in a
+        /// raster scan, which gives the same label image as the pixel-based
+        /// scans
+        ///
+        /// \param view   A view of some image data
+        /// \param labels Flattened label equivalences
+        /// \param order  Scratch table from roots to final labels
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        void relabel_blocks(array_view<RandomAccessIterator>& view,
+                            const union_find<iterator_value_type<RandomAccessIterator>>& labels,
+                            std::vector<iterator_value_type<RandomAccessIterator>>& order) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            if (!view.valid() || labels.empty()) {
+                throw exception("No data");
+            }
+
+            order.assign(labels.label_count() + 1, 0);
+            T next_label = 1;
+
+            for_each_element(view, [&](T& p) {
+                if (p) {
+                    T& o = order[labels.get(p)];
+
+                    if (!o) {
+                        o = next_label++;
+                    }
+
+                    p = o;
+                }
+            });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Relabel all connected components found by scan_blocks8 and
+        /// extract their features
+        ///
+        /// \param view       A view of some image data
+        /// \param labels     Flattened label equivalences
+        /// \param features   Static feature set or runtime extractor_set
+        /// \param components Vector of connected components, or the
+        ///                   rows of a component_table
+        /// \param order      Scratch table from roots to final labels
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename Features, typename Components>
+        void relabel_blocks(array_view<RandomAccessIterator>& view,
+                            const union_find<iterator_value_type<RandomAccessIterator>>& labels,
+                            const Features& features,
+                            Components& components,
+                            std::vector<iterator_value_type<RandomAccessIterator>>& order) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            if (!view.valid()) {
+                throw exception("View is empty");
+            }
+
+            order.assign(labels.label_count() + 1, 0);
+            T next_label = 1;
+
+            for (std::size_t y = 0; y < view.height(); ++y) {
+                const RandomAccessIterator row = view.row_begin(y);
+
+                for (std::size_t x = 0; x < view.width(); ++x) {
+                    T& e = row[x];
+
+                    if (e) {
+                        T& o = order[labels.get(e)];
+
+                        if (!o) {
+                            o = next_label++;
+                        }
+
+                        e = o;
+                        features.update(x, y, components[e - 1]);
+                    }
+                }
+            }
+        }
+    } // detail
+} // cvx
+
+#endif // CVX_BLOCK_LABEL_HPP
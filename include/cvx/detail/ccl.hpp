@@ -1,22 +1,26 @@
 #ifndef CVX_CCL_DETAIL_HPP
 #define CVX_CCL_DETAIL_HPP
 
+#include "cvx/bit_plane.hpp"
 #include "cvx/detail/contour.hpp"
+#include "cvx/detail/parallel_label.hpp"
 #include "cvx/detail/twopass_label.hpp"
 
 namespace cvx {
     namespace detail {
         //////////////////////////////////////////////////////////////////////
-        /// Label the connected components in an image given by a view
+        /// Label the connected components in an image given by a view. Every
+        /// element that differs from the background is foreground
         ///
         /// \param view               The view of some image data
         /// \param out                Output iterator for storing connected
         ///                           components, e.g. a std::vector<>
         /// \param connectivity       Neighbourhood connectivity (4 or 8)
-        /// \param foreground         Value of foreground elements
         /// \param background         Value of background elements
         /// \param flags              Bitflag of the component features to
         ///                           extract
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \param visited            Scratch bit plane for contour tracing
         /// \return The number of connected components found
         //////////////////////////////////////////////////////////////////////
         template<typename RandomAccessIterator,
@@ -24,9 +28,10 @@ namespace cvx {
         std::size_t label_connected_components_view(array_view<RandomAccessIterator>& view,
                                                     OutputIterator out,
                                                     unsigned char connectivity,
-                                                    iterator_value_type<RandomAccessIterator> foreground,
                                                     iterator_value_type<RandomAccessIterator> background,
-                                                    const feature_flag& flags) {
+                                                    const feature_flag& flags,
+                                                    label_engine engine,
+                                                    bit_plane& visited) {
             std::size_t label_count = 0;
 
             if (any_flags(flags & feature_flag::all_contours) > 0) {
@@ -35,20 +40,70 @@ namespace cvx {
                 label_count = contour_label(view,
                                             out,
                                             connectivity,
-                                            foreground,
                                             background,
-                                            flags);
+                                            flags,
+                                            visited);
             } else {
                 label_count = two_pass_label(view,
+                                             view,
                                              out,
                                              connectivity,
                                              background,
-                                             flags);
+                                             flags,
+                                             engine);
             }
 
             return label_count;
         }
 
+        //////////////////////////////////////////////////////////////////////
+        /// Label the connected components in an image given by a view into
+        /// a separate label image. The contour tracing algorithm works in
+        /// place, so it labels a binary copy of the input in the label image.
+        /// Every element that differs from the background is foreground
+        ///
+        /// \param input              The view of some image data
+        /// \param output             The view of the label image
+        /// \param out                Output iterator for storing connected
+        ///                           components, e.g. a std::vector<>
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param background         Value of background elements
+        /// \param flags              Bitflag of the component features to
+        ///                           extract
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator>
+        std::size_t label_connected_components_view(const array_view<InputIterator>& input,
+                                                    array_view<LabelIterator>& output,
+                                                    OutputIterator out,
+                                                    unsigned char connectivity,
+                                                    iterator_value_type<InputIterator> background,
+                                                    const feature_flag& flags,
+                                                    label_engine engine = label_engine::pixel) {
+            if (any_flags(flags & feature_flag::all_contours) > 0) {
+                bit_plane visited;
+
+                return contour_label(input,
+                                     output,
+                                     out,
+                                     connectivity,
+                                     background,
+                                     flags,
+                                     visited);
+            }
+
+            return two_pass_label(input,
+                                  output,
+                                  out,
+                                  connectivity,
+                                  background,
+                                  flags,
+                                  engine);
+        }
+
         //////////////////////////////////////////////////////////////////////
         /// Validate the given arguments. Throws an exception if validation
         /// fails
@@ -88,6 +143,7 @@ namespace cvx {
         /// \param connectivity       Neighbourhood connectivity (4 or 8)
         /// \param pred               Unary predicate that identifies a
         ///                           background element
+        /// \param engine             Scan strategy of the two-pass algorithm
         /// \return The number of connected components found
         //////////////////////////////////////////////////////////////////////
         template<typename RandomAccessIterator>
@@ -97,7 +153,8 @@ namespace cvx {
                                                std::size_t height,
                                                unsigned char connectivity,
                                                iterator_value_type<RandomAccessIterator> foreground,
-                                               iterator_value_type<RandomAccessIterator> background) {
+                                               iterator_value_type<RandomAccessIterator> background,
+                                               label_engine engine = label_engine::pixel) {
             validate_arguments(connectivity, foreground, background);
 
             array_view<RandomAccessIterator> view(first,
@@ -105,7 +162,214 @@ namespace cvx {
                                                   width,
                                                   height);
 
-            return two_pass_label(view, connectivity, background);
+            return two_pass_label(view, view, connectivity, background, engine);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Parallel version of the connected component algorithm that labels
+        /// horizontal strips of the image data on a pool of threads. Does not
+        /// extract components
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param pool               Threads to label the image data with
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        std::size_t label_connected_components(RandomAccessIterator first,
+                                               RandomAccessIterator last,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<RandomAccessIterator> foreground,
+                                               iterator_value_type<RandomAccessIterator> background,
+                                               thread_pool& pool) {
+            validate_arguments(connectivity, foreground, background);
+
+            array_view<RandomAccessIterator> view(first,
+                                                  last,
+                                                  width,
+                                                  height);
+
+            return parallel_two_pass_label(view, view, connectivity, background, pool);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Validate the given arguments and views. Throws an exception if
+        /// validation fails
+        ///
+        /// \param input        The view of some image data
+        /// \param output       The view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param foreground   Value of foreground elements
+        /// \param background   Value of background elements
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        void validate_arguments(const array_view<InputIterator>& input,
+                                const array_view<LabelIterator>& output,
+                                unsigned char connectivity,
+                                const iterator_value_type<InputIterator>& foreground,
+                                const iterator_value_type<InputIterator>& background) {
+            validate_arguments(connectivity, foreground, background);
+
+            // Ranges of strided views also span their padding
+            if (input.width() != output.width() ||
+                input.height() != output.height() ||
+                (input.contiguous() && output.contiguous() &&
+                 std::distance(input.cbegin(), input.cend()) != std::distance(output.cbegin(), output.cend()))) {
+                throw exception("Input and output must have the same size");
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that reads from a constant range
+        /// of image data and writes the labels to a separate range, whose
+        /// element type is the label type. Does not extract components
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param labels_first       Iterator to the beginning of the label
+        ///                           image
+        /// \param labels_last        Iterator to the end of the label image
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t label_connected_components(InputIterator first,
+                                               InputIterator last,
+                                               LabelIterator labels_first,
+                                               LabelIterator labels_last,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<InputIterator> foreground,
+                                               iterator_value_type<InputIterator> background,
+                                               label_engine engine = label_engine::pixel) {
+            const array_view<InputIterator> input(first, last, width, height);
+            array_view<LabelIterator> output(labels_first, labels_last, width, height);
+
+            validate_arguments(input, output, connectivity, foreground, background);
+
+            return two_pass_label(input, output, connectivity, background, engine);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Parallel connected component algorithm that reads from a constant
+        /// range of image data and writes the labels to a separate range.
+        /// Does not extract components
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param labels_first       Iterator to the beginning of the label
+        ///                           image
+        /// \param labels_last        Iterator to the end of the label image
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param pool               Threads to label the image data with
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t label_connected_components(InputIterator first,
+                                               InputIterator last,
+                                               LabelIterator labels_first,
+                                               LabelIterator labels_last,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<InputIterator> foreground,
+                                               iterator_value_type<InputIterator> background,
+                                               thread_pool& pool) {
+            const array_view<InputIterator> input(first, last, width, height);
+            array_view<LabelIterator> output(labels_first, labels_last, width, height);
+
+            validate_arguments(input, output, connectivity, foreground, background);
+
+            return parallel_two_pass_label(input, output, connectivity, background, pool);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that reads from a constant range
+        /// of image data, writes the labels to a separate range and extracts
+        /// the features of each component
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param labels_first       Iterator to the beginning of the label
+        ///                           image
+        /// \param labels_last        Iterator to the end of the label image
+        /// \param out                Output iterator for storing connected
+        ///                           components, e.g. a std::vector<>
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param flags              Bitflag of the component features to
+        ///                           extract
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator>
+        std::size_t label_connected_components(InputIterator first,
+                                               InputIterator last,
+                                               LabelIterator labels_first,
+                                               LabelIterator labels_last,
+                                               OutputIterator out,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<InputIterator> foreground,
+                                               iterator_value_type<InputIterator> background,
+                                               const feature_flag& flags = feature_flag::none,
+                                               label_engine engine = label_engine::pixel) {
+            if (!any_flags(flags)) {
+                return detail::label_connected_components(first,
+                                                          last,
+                                                          labels_first,
+                                                          labels_last,
+                                                          width,
+                                                          height,
+                                                          connectivity,
+                                                          foreground,
+                                                          background,
+                                                          engine);
+            }
+
+            const array_view<InputIterator> input(first, last, width, height);
+            array_view<LabelIterator> output(labels_first, labels_last, width, height);
+
+            validate_arguments(input, output, connectivity, foreground, background);
+
+            return label_connected_components_view(input,
+                                                   output,
+                                                   out,
+                                                   connectivity,
+                                                   background,
+                                                   flags,
+                                                   engine);
         }
 
         //////////////////////////////////////////////////////////////////////
@@ -126,6 +390,9 @@ namespace cvx {
         /// \param background         Value of background elements
         /// \param flags              Bitflag of the component features to
         ///                           extract
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \param visited            Scratch bit plane for contour tracing,
+        ///                           reused across calls
         /// \return The number of connected components found
         //////////////////////////////////////////////////////////////////////
         template<typename RandomAccessIterator,
@@ -138,7 +405,9 @@ namespace cvx {
                                                unsigned char connectivity,
                                                iterator_value_type<RandomAccessIterator> foreground,
                                                iterator_value_type<RandomAccessIterator> background,
-                                               const feature_flag& flags = feature_flag::none) {
+                                               const feature_flag& flags,
+                                               label_engine engine,
+                                               bit_plane& visited) {
             // TODO: Necessary?
             //if (first == last) {
             //    return 0;
@@ -155,20 +424,242 @@ namespace cvx {
                 return label_connected_components_view(view,
                                                        out,
                                                        connectivity,
-                                                       foreground,
                                                        background,
-                                                       flags);
+                                                       flags,
+                                                       engine,
+                                                       visited);
             }
 
             // If no features need to be extracted, call the function
             // that does no extraction instead
-            return label_connected_components(first,
-                                              last,
-                                              width,
-                                              height,
-                                              connectivity,
-                                              foreground,
-                                              background);
+            return detail::label_connected_components(first,
+                                                      last,
+                                                      width,
+                                                      height,
+                                                      connectivity,
+                                                      foreground,
+                                                      background,
+                                                      engine);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Implementation of the connected component algorithm based on:
+        /// "Optimizing two-pass connected-component labeling algorithms" by
+        /// Kesheng Wu, Ekow Otoo and Kenji Suzuki
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param out                Output iterator for storing connected
+        ///                           components, e.g. a std::vector<>
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param flags              Bitflag of the component features to
+        ///                           extract
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator,
+                 typename OutputIterator>
+        std::size_t label_connected_components(RandomAccessIterator first,
+                                               RandomAccessIterator last,
+                                               OutputIterator out,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<RandomAccessIterator> foreground,
+                                               iterator_value_type<RandomAccessIterator> background,
+                                               const feature_flag& flags = feature_flag::none,
+                                               label_engine engine = label_engine::pixel) {
+            bit_plane visited;
+
+            return detail::label_connected_components(first,
+                                                      last,
+                                                      out,
+                                                      width,
+                                                      height,
+                                                      connectivity,
+                                                      foreground,
+                                                      background,
+                                                      flags,
+                                                      engine,
+                                                      visited);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that extracts a static feature set
+        /// given at compile-time
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param out                Output iterator for storing connected
+        ///                           components, e.g. a std::vector<>
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param features           Static feature set, e.g. features<area>
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator,
+                 typename OutputIterator,
+                 typename... Features>
+        std::size_t label_connected_components(RandomAccessIterator first,
+                                               RandomAccessIterator last,
+                                               OutputIterator out,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<RandomAccessIterator> foreground,
+                                               iterator_value_type<RandomAccessIterator> background,
+                                               const cvx::features<Features...>& features,
+                                               label_engine engine) {
+            validate_arguments(connectivity, foreground, background);
+
+            array_view<RandomAccessIterator> view(first,
+                                                  last,
+                                                  width,
+                                                  height);
+
+            return two_pass_label(view, view, out, connectivity, background, features, engine);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that reads from a constant range
+        /// of image data, writes the labels to a separate range and extracts
+        /// a static feature set given at compile-time
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param labels_first       Iterator to the beginning of the label
+        ///                           image
+        /// \param labels_last        Iterator to the end of the label image
+        /// \param out                Output iterator for storing connected
+        ///                           components, e.g. a std::vector<>
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param features           Static feature set, e.g. features<area>
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator,
+                 typename... Features>
+        std::size_t label_connected_components(InputIterator first,
+                                               InputIterator last,
+                                               LabelIterator labels_first,
+                                               LabelIterator labels_last,
+                                               OutputIterator out,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<InputIterator> foreground,
+                                               iterator_value_type<InputIterator> background,
+                                               const cvx::features<Features...>& features,
+                                               label_engine engine) {
+            const array_view<InputIterator> input(first, last, width, height);
+            array_view<LabelIterator> output(labels_first, labels_last, width, height);
+
+            validate_arguments(input, output, connectivity, foreground, background);
+
+            return two_pass_label(input, output, out, connectivity, background, features, engine);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that labels image data in place and
+        /// extracts the area, centroid and bounding box of each component
+        /// into a component table
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data
+        /// \param last               Iterator to the end of the image data
+        /// \param table              Receives the features of all
+        ///                           components
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        std::size_t label_connected_components(RandomAccessIterator first,
+                                               RandomAccessIterator last,
+                                               component_table& table,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<RandomAccessIterator> foreground,
+                                               iterator_value_type<RandomAccessIterator> background,
+                                               label_engine engine = label_engine::pixel) {
+            validate_arguments(connectivity, foreground, background);
+
+            array_view<RandomAccessIterator> view(first,
+                                                  last,
+                                                  width,
+                                                  height);
+            two_pass_scratch<iterator_value_type<RandomAccessIterator>> scratch;
+
+            return two_pass_label_table(view, view, connectivity, background, engine, scratch, table);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Connected component algorithm that reads from a constant range
+        /// of image data, writes the labels to a separate range and extracts
+        /// the area, centroid and bounding box of each component into a
+        /// component table
+        ///
+        /// \param first              Iterator to the beginning of the image
+        ///                           data source
+        /// \param last               Iterator to the end of the image data
+        ///                           source
+        /// \param labels_first       Iterator to the beginning of the label
+        ///                           image
+        /// \param labels_last        Iterator to the end of the label image
+        /// \param table              Receives the features of all
+        ///                           components
+        /// \param width              Width of the image data
+        /// \param height             Height of the image data
+        /// \param connectivity       Neighbourhood connectivity (4 or 8)
+        /// \param foreground         Value of foreground elements
+        /// \param background         Value of background elements
+        /// \param engine             Scan strategy of the two-pass algorithm
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t label_connected_components(InputIterator first,
+                                               InputIterator last,
+                                               LabelIterator labels_first,
+                                               LabelIterator labels_last,
+                                               component_table& table,
+                                               std::size_t width,
+                                               std::size_t height,
+                                               unsigned char connectivity,
+                                               iterator_value_type<InputIterator> foreground,
+                                               iterator_value_type<InputIterator> background,
+                                               label_engine engine = label_engine::pixel) {
+            const array_view<InputIterator> input(first, last, width, height);
+            array_view<LabelIterator> output(labels_first, labels_last, width, height);
+            two_pass_scratch<iterator_value_type<LabelIterator>> scratch;
+
+            validate_arguments(input, output, connectivity, foreground, background);
+
+            return two_pass_label_table(input, output, connectivity, background, engine, scratch, table);
         }
     } // detail
 } // cvx
@@ -2,11 +2,12 @@
 #define CVX_CONTOUR_DETAIL_HPP
 
 #include "cvx/array_view.hpp"
+#include "cvx/bit_plane.hpp"
 #include "cvx/exception.hpp"
+#include "cvx/trace.hpp"
+#include <algorithm>
 #include <iterator>
-#include <unordered_set>
-
-#include <iostream>
+#include <limits>
 
 namespace {
     //////////////////////////////////////////////////////////////////////
@@ -19,14 +20,14 @@ namespace {
     ///   / | \
     ///  3  2  1
     //////////////////////////////////////////////////////////////////////
-    char trace_directions[][2] = { {1, 1},
-                                   {1, 0},
-                                   {1, -1},
-                                   {0, -1},
-                                   {-1, -1},
-                                   {-1, 0},
-                                   {-1, 1},
-                                   {0, 1} };
+    const int trace_directions[][2] = { {1, 0},
+                                        {1, 1},
+                                        {0, 1},
+                                        {-1, 1},
+                                        {-1, 0},
+                                        {-1, -1},
+                                        {0, -1},
+                                        {1, -1} };
 }
 
 namespace cvx {
@@ -116,37 +117,45 @@ namespace cvx {
         }
 
         //////////////////////////////////////////////////////////////////////
-        /// Get the next contour point according to the Moore neighbourhood
+        /// Get the next contour point according to the Moore neighbourhood,
+        /// searching clockwise from the given direction. Background
+        /// neighbours that are examined are marked, so that the scan does
+        /// not start another trace of the same internal contour
         ///
-        /// \param view  View of image data
-        /// \param point Point in question
-        /// \param dir   The direction to search in
-        /// \return Number of Moore neighbourhood pixels checked
+        /// \param view      View of image data
+        /// \param point     Point in question, receives the next point
+        /// \param direction The direction to start searching in, receives
+        ///                  the direction of the next point
+        /// \param marked    Bit plane of marked background elements
+        /// \return Number of Moore neighbourhood pixels checked, 9 if none
+        ///         of them are foreground
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator>
+        template<typename RandomAccessIterator,
+                 typename AssociativeContainer>
         int next_contour_point(const array_view<RandomAccessIterator>& view,
                                point2i& point,
                                int& direction,
-                               typename std::iterator_traits<RandomAccessIterator>::value_type background) {
+                               typename std::iterator_traits<RandomAccessIterator>::value_type background,
+                               AssociativeContainer& marked) {
             int count = 0;
-            point2i temp_point;
 
             while (count++ < 8) {
-                temp_point.x = point.x + trace_directions[direction][0];
-                temp_point.y = point.y + trace_directions[direction][1];
+                const point2i next(point.x + trace_directions[direction][0],
+                                   point.y + trace_directions[direction][1]);
 
-                if (view.contains(temp_point)) {
-                    if (view(temp_point) == background) {
-                        direction = ++direction % 8;
-                    } else {
+                if (view.contains(next)) {
+                    if (!(view(next) == background)) {
+                        point.x = next.x;
+                        point.y = next.y;
                         break;
                     }
-                } else {
-                    direction = ++direction % 8;
+
+                    marked.set(next.x, next.y);
                 }
+
+                direction = (direction + 1) % 8;
             }
 
-            point = temp_point;
             return count;
         }
 
@@ -174,18 +183,38 @@ namespace cvx {
         }
 
         //////////////////////////////////////////////////////////////////////
-        /// \param T          Element type
-        /// \param value      Value type of the elements
-        /// \param foreground Value denoting foreground elements
-        /// \param background Value denoting background elements
-        /// \return True if the point value is an unlabelled element
+        /// \param marked Bit plane of marked background and labelled
+        ///               foreground elements
+        /// \param x      X-coordinate of a foreground element
+        /// \param y      Y-coordinate of a foreground element
+        /// \return True if the foreground element is not labelled yet
         //////////////////////////////////////////////////////////////////////
-        template<typename T>
-        bool is_unlabelled(const T& value,
-                           const T& foreground) {
-            return (value == foreground);
+        template<typename AssociativeContainer>
+        bool is_unlabelled(const AssociativeContainer& marked,
+                           std::size_t x,
+                           std::size_t y) {
+            return !marked.test(x, y);
         }
 
+        //////////////////////////////////////////////////////////////////////
+        /// An output iterator that discards everything written to it, for
+        /// tracing contours that are only needed to label the image
+        //////////////////////////////////////////////////////////////////////
+        struct discard_iterator {
+            using iterator_category = std::output_iterator_tag;
+            using value_type        = void;
+            using difference_type   = void;
+            using pointer           = void;
+            using reference         = void;
+
+            discard_iterator& operator*() { return *this; }
+            discard_iterator& operator++() { return *this; }
+            discard_iterator& operator++(int) { return *this; }
+
+            template<typename T>
+            discard_iterator& operator=(const T&) { return *this; }
+        };
+
         //////////////////////////////////////////////////////////////////////
         /// Trace a single contour in binary image data
         ///
@@ -216,12 +245,16 @@ namespace cvx {
         /// Trace a single contour in binary image data from a given starting
         /// point.
         ///
-        /// This implements the "Contour tracing" procedure from the article,
-        /// and since contour tracing is not used for labelling here, we do
-        /// not need to label white pixels with negative integers.
+        /// This implements the "Contour tracing" procedure from the article.
+        /// Instead of labelling white pixels with negative integers, the
+        /// examined background pixels are marked in a bit plane, as are the
+        /// contour points once they are labelled. Tracing stops when it is
+        /// back at the starting point and the next point is the second point
+        /// of the contour again
         ///
         /// \param RandomAccessIterator Image data type
-        /// \param AssociativeContainer An associative container type
+        /// \param AssociativeContainer Type of the marked points, e.g. a
+        ///                             bit_plane
         /// \param OutputIterator       The type of the output iterator for
         ///                             storing the contour
         /// \param view                 View of the image data
@@ -229,8 +262,8 @@ namespace cvx {
         ///                             from
         /// \param y                    Y-coordinate of the starting to trace
         ///                             from
-        /// \param marked               Marked external and internal contour
-        ///                             points
+        /// \param marked               Bit plane of marked background and
+        ///                             labelled foreground points
         /// \param out                  Output iterator to store the contour
         /// \param background           Value of background elements
         //////////////////////////////////////////////////////////////////////
@@ -245,47 +278,58 @@ namespace cvx {
                            AssociativeContainer& marked,
                            typename std::iterator_traits<RandomAccessIterator>::value_type background,
                            bool is_external) {
-            point2i start(x, y);
+            const point2i start(x, y);
             point2i pos = start;
-            int next_dir = (is_external ? 7 : 3);
-            int first_dir = next_dir;
-
-            if (!is_external) {
-                marked.emplace(x, y);
-            }
+            int direction = (is_external ? 7 : 3);
 
             view(start) = label;
+            marked.set(start.x, start.y);
             *out++ = pos;
 
-            std::cout << x << ", " << y << std::endl;
+            // Only consumed by the trace hook, compiled away otherwise
+            std::size_t steps = std::min(next_contour_point(view, pos, direction, background, marked), 8);
+            std::size_t length = 1;
 
-            // Start tracing the contour until we encounter the starting point
-            // again and the next point is the same as when we started
-            do {
-                int count = next_contour_point(view, pos, next_dir, background);
+            // An isolated point has no foreground neighbours
+            if (pos != start) {
+                const point2i second = pos;
 
-                std::cout << next_dir << std::endl;
+                while (true) {
+                    const point2i current = pos;
 
-                if (count == 8) {
-                    // We are tracing an isolated point, so stop here
-                    break;
-                } else {
-                    view(pos) = label;
-                    *out++ = pos;
-                    next_dir = ++next_dir % 8;
+                    if (current != start) {
+                        view(current) = label;
+                        marked.set(current.x, current.y);
+                        *out++ = current;
+                        ++length;
+                    }
+
+                    // Search clockwise from the neighbour after the previous
+                    // contour point
+                    direction = (direction + 6) % 8;
+                    steps += std::min(next_contour_point(view, pos, direction, background, marked), 8);
 
-                    if (is_internal_contour(view, x, y, background)) {
-                        marked.emplace(pos.x, pos.y);
+                    if (current == start && pos == second) {
+                        break;
+                    } else if (current == start) {
+                        // The contour passes through the starting point again
+                        *out++ = current;
+                        ++length;
                     }
                 }
-            } while (pos != start && next_dir != first_dir);
+            }
+
+            CVX_TRACE_CONTOUR(start, steps, length, is_external);
+            static_cast<void>(steps);
+            static_cast<void>(length);
         }
 
         //////////////////////////////////////////////////////////////////////
         /// Trace a single external contour.
         ///
         /// \param RandomAccessIterator Image data type
-        /// \param AssociativeContainer An associative container type
+        /// \param AssociativeContainer Type of the marked points, e.g. a
+        ///                             bit_plane
         /// \param view                 View of the image data
         /// \param x                    X-coordinate of the starting to trace
         ///                             from
@@ -293,7 +337,7 @@ namespace cvx {
         ///                             from
         /// \param cc                   Connected component associated with
         ///                             the external contour
-        /// \param marked               Marked external and internal contour
+        /// \param marked               Bit plane of marked background
         ///                             points
         /// \param background           Value of background elements
         //////////////////////////////////////////////////////////////////////
@@ -322,7 +366,8 @@ namespace cvx {
         /// Trace a single internal contour.
         ///
         /// \param RandomAccessIterator Image data type
-        /// \param AssociativeContainer An associative container type
+        /// \param AssociativeContainer Type of the marked points, e.g. a
+        ///                             bit_plane
         /// \param view                 View of the image data
         /// \param x                    X-coordinate of the starting to trace
         ///                             from
@@ -330,7 +375,7 @@ namespace cvx {
         ///                             from
         /// \param cc                   Connected component associated with
         ///                             the external contour
-        /// \param marked               Marked external and internal contour
+        /// \param marked               Bit plane of marked background
         ///                             points
         /// \param background           Value of background elements
         //////////////////////////////////////////////////////////////////////
@@ -347,8 +392,6 @@ namespace cvx {
             auto out = std::back_inserter(cc._inner_contours.back());
             bool is_external = false;
 
-            std::cout << "i" << std::endl;
-
             trace_contour(view,
                           x, y,
                           cc.label(),
@@ -376,62 +419,89 @@ namespace cvx {
         /// \param width          Width of the image data
         /// \param height         Height of the image data
         /// \param connectivity   Neighbourhood connectivity (4 or 8)
-        /// \param background     Value of background elements
+        /// \param background     Value of background elements, all other
+        ///                       elements are foreground
+        /// \param marked         Scratch bit plane for marking examined
+        ///                       background points and labelled foreground
+        ///                       points. It is resized to the view, so it
+        ///                       can be reused across calls
         //////////////////////////////////////////////////////////////////////
         template<typename RandomAccessIterator,
                  typename OutputIterator>
         std::size_t contour_label(array_view<RandomAccessIterator>& view,
                                   OutputIterator out,
                                   unsigned char connectivity,
-                                  typename std::iterator_traits<RandomAccessIterator>::value_type foreground,
                                   typename std::iterator_traits<RandomAccessIterator>::value_type background,
-                                  const feature_flag& flags) {
+                                  const feature_flag& flags,
+                                  bit_plane& marked) {
             using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
 
             std::size_t label_count = 0;
             const bool extract_inner_contours = any_flags(flags & feature_flag::inner_contours);
             std::vector<connected_component> components;
 
-            // We separately track marked pixels to avoid modifying mage data
-            // (Is there a better alternative?)
-            std::unordered_set<point2i> marked;
+            // We separately track marked background pixels to avoid
+            // modifying image data, and labelled foreground pixels so that
+            // labels can take any value, including that of the foreground
+            marked.reset(view.width(), view.height());
 
             for (std::size_t y = 0; y < view.height(); ++y) {
+                // The last row has no row below, below is never read for it
+                const bool has_below = (y + 1 < view.height());
+                const RandomAccessIterator row = view.row_begin(y);
+                const RandomAccessIterator below = view.row_begin(has_below ? y + 1 : y);
+
                 for (std::size_t x = 0; x < view.width(); ++x) {
-                    value_type& e = view(y, x);
-                    
-                    //if (y > 0 && e == 0) {
-                    //    std::cout << e << ", " << view(y - 1, x) << std::endl;
-                    //}
+                    value_type& e = row[x];
 
                     if (e == background) {
-                        //e = 0;
-                    } else if (is_unlabelled(e, foreground)) {
-                        if (is_external_contour(view, x, y, background)) {
-                            std::cout << "EXTERNAL" << std::endl;
-                            components.emplace_back(++label_count);
-                            e = label_count;
-
-                            trace_external_contour(view,
+                        continue;
+                    }
+
+                    if (is_unlabelled(marked, x, y) && is_external_contour(view, x, y, background)) {
+                        // Contour labels are final, so there is nothing to
+                        // fall back to once they no longer fit
+                        if (label_count >= static_cast<std::size_t>(std::numeric_limits<value_type>::max())) {
+                            throw exception("Too many connected components for the label type");
+                        }
+
+                        components.emplace_back(++label_count);
+                        e = static_cast<value_type>(label_count);
+
+                        trace_external_contour(view,
+                                               x, y,
+                                               components.back(),
+                                               background,
+                                               marked);
+                    }
+
+                    // An unmarked background pixel below starts a new internal
+                    // contour, which must be traced to label the elements
+                    // around the hole even if it is not extracted
+                    if (has_below && below[x] == background && !marked.test(x, y + 1)) {
+                        if (is_unlabelled(marked, x, y)) {
+                            e = row[x - 1];
+                            marked.set(x, y);
+                        }
+
+                        if (extract_inner_contours) {
+                            trace_internal_contour(view,
                                                    x, y,
-                                                   components.back(),
+                                                   components[e - 1],
                                                    background,
                                                    marked);
-                        } else if (extract_inner_contours) {
-                            if (is_internal_contour(view, x, y, background)) {
-                                if (marked.count(point2i(x, y)) == 0) {
-                                    trace_internal_contour(view,
-                                                           x, y,
-                                                           components[e - 1],
-                                                           background,
-                                                           marked);
-                                }
-
-                                e = view(y, x - 1);
-                            }
                         } else {
-                            e = view(y, x - 1);
+                            trace_contour(view,
+                                          x, y,
+                                          static_cast<unsigned int>(e),
+                                          discard_iterator(),
+                                          marked,
+                                          background,
+                                          false);
                         }
+                    } else if (is_unlabelled(marked, x, y)) {
+                        e = row[x - 1];
+                        marked.set(x, y);
                     }
                 }
             }
@@ -444,6 +514,47 @@ namespace cvx {
 
             return label_count;
         }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the connected components of a constant view into a separate
+        /// label image and trace all contours. Contour tracing works in
+        /// place, so it labels a binary copy of the input in the label image.
+        /// The labelled elements are tracked in the bit plane rather than by
+        /// value, so all labels of the label type can be used
+        ///
+        /// \param input        A view of the image data
+        /// \param output       A view of the label image
+        /// \param out          Output iterator for storing connected
+        ///                     components, e.g. a std::vector<>
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param flags        Bitflag of the component features to extract
+        /// \param marked       Scratch bit plane for contour tracing
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator>
+        std::size_t contour_label(const array_view<InputIterator>& input,
+                                  array_view<LabelIterator>& output,
+                                  OutputIterator out,
+                                  unsigned char connectivity,
+                                  typename std::iterator_traits<InputIterator>::value_type background,
+                                  const feature_flag& flags,
+                                  bit_plane& marked) {
+            using T = typename std::iterator_traits<LabelIterator>::value_type;
+
+            transform_view(input, output, [background](typename std::iterator_traits<InputIterator>::value_type e) {
+                return e == background ? T(0) : T(1);
+            });
+
+            return contour_label(output,
+                                 out,
+                                 connectivity,
+                                 T(0),
+                                 flags,
+                                 marked);
+        }
     } // detail
 } // cvx
 
@@ -14,6 +14,10 @@ namespace cvx {
             public:
                 virtual void initialise(connected_component& component);
                 virtual void update(std::size_t x, std::size_t y, connected_component& component);
+
+                // Update with the elements [x_begin, x_end) of row y, by
+                // default one element at a time
+                virtual void update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component);
                 virtual void finalise(connected_component& component);
         };
     } // detail
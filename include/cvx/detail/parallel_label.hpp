@@ -0,0 +1,178 @@
+#ifndef CVX_PARALLEL_LABEL_HPP
+#define CVX_PARALLEL_LABEL_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/concurrent_union_find.hpp"
+#include "cvx/thread_pool.hpp"
+#include "cvx/union_find.hpp"
+#include "cvx/utils.hpp"
+#include "cvx/detail/twopass_label.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Merge the labels of two vertically adjacent rows that belong to
+        /// different strips
+        ///
+        /// \param above        Last row of the upper strip
+        /// \param below        First row of the lower strip
+        /// \param width        Width of the rows
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param above_labels Flattened labels of the upper strip
+        /// \param below_labels Flattened labels of the lower strip
+        /// \param above_offset First global label of the upper strip
+        /// \param below_offset First global label of the lower strip
+        /// \param labels       Global label equivalences, shared by all
+        ///                     borders
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename T>
+        void merge_strip_border(RandomAccessIterator above,
+                                RandomAccessIterator below,
+                                std::size_t width,
+                                unsigned char connectivity,
+                                const union_find<T>& above_labels,
+                                const union_find<T>& below_labels,
+                                std::size_t above_offset,
+                                std::size_t below_offset,
+                                concurrent_union_find<T>& labels) {
+            for (std::size_t x = 0; x < width; ++x) {
+                const T b = below[x];
+
+                if (!b) {
+                    continue;
+                }
+
+                const T global_b = static_cast<T>(below_labels.get(b) + below_offset);
+                const std::size_t first = (connectivity == 8 && x > 0 ? x - 1 : x);
+                const std::size_t last = (connectivity == 8 ? std::min(x + 1, width - 1) : x);
+
+                for (std::size_t i = first; i <= last; ++i) {
+                    const T a = above[i];
+
+                    if (a) {
+                        labels.merge(static_cast<T>(above_labels.get(a) + above_offset), global_b);
+                    }
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label connected components in parallel. The view is split into
+        /// horizontal strips that are scanned and flattened independently
+        /// with their own label equivalences. The strips' labels are then
+        /// offset into disjoint ranges of a global concurrent union-find,
+        /// merged across all strip borders at once and finally relabelled in
+        /// parallel.
+        ///
+        /// Since every strip is scanned in raster order and the global
+        /// labels are ordered by strip, the result is identical to the
+        /// sequential two_pass_label
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image, may be the same as
+        ///                     input
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param pool         Threads to run the strips on
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t parallel_two_pass_label(const array_view<InputIterator>& input,
+                                            array_view<LabelIterator>& output,
+                                            unsigned char connectivity,
+                                            iterator_value_type<InputIterator> background,
+                                            thread_pool& pool) {
+            using T = iterator_value_type<LabelIterator>;
+            const std::size_t width = output.width();
+            const std::size_t strip_count = std::min(pool.size(), output.height());
+
+            if (strip_count < 2) {
+                return two_pass_label(input, output, connectivity, background, label_engine::pixel);
+            }
+
+            const std::size_t strip_height = (output.height() + strip_count - 1) / strip_count;
+            std::vector<array_view<InputIterator>> input_strips;
+            std::vector<array_view<LabelIterator>> strips;
+
+            for (std::size_t y = 0; y < output.height(); y += strip_height) {
+                const std::size_t height = std::min(strip_height, output.height() - y);
+
+                const rectangle2i bounds(0, static_cast<int>(y), static_cast<int>(width), static_cast<int>(height));
+
+                input_strips.push_back(input.subview(bounds));
+                strips.push_back(output.subview(bounds));
+            }
+
+            std::vector<union_find<T>> strip_labels(strips.size());
+
+            // 1. Scan and flatten each strip independently
+            pool.parallel_for(strips.size(), [&](std::size_t s) {
+                if (connectivity == 4) {
+                    scan_labels4(input_strips[s], strips[s], strip_labels[s], background);
+                } else {
+                    scan_labels8(input_strips[s], strips[s], strip_labels[s], background);
+                }
+
+                strip_labels[s].flatten();
+            });
+
+            // 2. Give each strip a disjoint range of global labels
+            std::vector<std::size_t> offsets(strips.size(), 0);
+            std::size_t label_count = 0;
+            bool overflow = false;
+
+            for (std::size_t s = 0; s < strips.size(); ++s) {
+                offsets[s] = label_count;
+                label_count += strip_labels[s].label_count();
+                overflow = overflow || strip_labels[s].overflow();
+            }
+
+            // The strips' labels must fit T together, otherwise fall back to
+            // a sequential labelling with a wider label type
+            if (overflow || label_count > static_cast<std::size_t>(std::numeric_limits<T>::max())) {
+                return wide_two_pass_label(output, connectivity, label_engine::pixel);
+            }
+
+            concurrent_union_find<T> labels(label_count + 1);
+
+            // 3. Merge equivalences across all strip borders concurrently
+            pool.parallel_for(strips.size() - 1, [&](std::size_t border) {
+                const std::size_t s = border + 1;
+                auto above = strips[s - 1].row_begin(strips[s - 1].height() - 1);
+
+                merge_strip_border(above,
+                                   strips[s].row_begin(0),
+                                   width,
+                                   connectivity,
+                                   strip_labels[s - 1],
+                                   strip_labels[s],
+                                   offsets[s - 1],
+                                   offsets[s],
+                                   labels);
+            });
+
+            labels.flatten();
+
+            // 4. Map each strip's provisional labels to their final labels
+            //    and relabel all strips
+            pool.parallel_for(strips.size(), [&](std::size_t s) {
+                std::vector<T> final_labels(strip_labels[s].size(), 0);
+
+                for (std::size_t i = 1; i < final_labels.size(); ++i) {
+                    final_labels[i] = labels.get(strip_labels[s].get(i) + offsets[s]);
+                }
+
+                for_each_span(strips[s], [&final_labels](LabelIterator first, std::size_t count) {
+                    relabel_span(first, count, final_labels.data(), final_labels.size());
+                });
+            });
+
+            return labels.label_count();
+        }
+    } // detail
+} // cvx
+
+#endif // CVX_PARALLEL_LABEL_HPP
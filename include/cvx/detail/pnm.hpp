@@ -0,0 +1,59 @@
+#ifndef CVX_PNM_HPP
+#define CVX_PNM_HPP
+
+#include "cvx/export.hpp"
+#include <cstddef>
+#include <limits>
+#include <string>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// The binary netpbm formats whose pixels can be used in place
+        //////////////////////////////////////////////////////////////////////
+        enum class pnm_format : unsigned int {
+            pbm = 4, /// P4, one bit per pixel, set bits are black
+            pgm = 5  /// P5, one or two big-endian bytes per pixel
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// The header of a binary PBM or PGM file and the layout of the
+        /// pixel data that follows it
+        //////////////////////////////////////////////////////////////////////
+        struct pnm_header {
+            pnm_format format;
+            std::size_t width;
+            std::size_t height;
+            std::size_t maxval;
+            std::size_t offset; // Offset of the first pixel in bytes
+            std::size_t stride; // Number of bytes between rows
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return True if a * b does not fit in std::size_t, checked
+        ///         by dividing before multiplying
+        //////////////////////////////////////////////////////////////////////
+        inline bool multiply_overflows(std::size_t a, std::size_t b) {
+            return a != 0 && b > std::numeric_limits<std::size_t>::max() / a;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return True if a + b does not fit in std::size_t
+        //////////////////////////////////////////////////////////////////////
+        inline bool add_overflows(std::size_t a, std::size_t b) {
+            return b > std::numeric_limits<std::size_t>::max() - a;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Parse the header of a binary PBM (P4) or PGM (P5) file,
+        /// including comments. Throws if the file is neither, or if the
+        /// size of its pixel data does not fit in std::size_t
+        ///
+        /// \param path Path of the file
+        /// \return The parsed header
+        //////////////////////////////////////////////////////////////////////
+        CVX_EXPORT pnm_header read_pnm_header(const std::string& path);
+    } // detail
+} // cvx
+
+#endif // CVX_PNM_HPP
@@ -0,0 +1,298 @@
+#ifndef CVX_RUN_LABEL_HPP
+#define CVX_RUN_LABEL_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/bit_view.hpp"
+#include "cvx/connected_component.hpp"
+#include "cvx/exception.hpp"
+#include "cvx/union_find.hpp"
+#include "cvx/utils.hpp"
+#include "cvx/detail/simd.hpp"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// A horizontal run of foreground elements [start, end[ in a row
+        /// and its provisional label
+        //////////////////////////////////////////////////////////////////////
+        template<typename T>
+        struct label_run {
+            std::size_t start;
+            std::size_t end;
+            T label;
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// Append the runs of foreground elements in a row by searching it
+        /// element by element, or with the SIMD kernels for contiguous
+        /// integer rows
+        ///
+        /// \param row        Iterator to the beginning of the row
+        /// \param width      Width of the row
+        /// \param background Value of background elements
+        /// \param runs       Runs to append to
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename T>
+        void extract_element_runs(InputIterator row,
+                                  std::size_t width,
+                                  iterator_value_type<InputIterator> background,
+                                  std::vector<label_run<T>>& runs) {
+            std::size_t x = 0;
+
+            while (x < width) {
+                const std::size_t start = find_foreground(row, x, width, background);
+
+                if (start == width) {
+                    break;
+                }
+
+                x = find_background(row, start, width, background);
+                runs.push_back(label_run<T>{ start, x, T(0) });
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Append the runs of foreground elements in a row. Contiguous
+        /// integer rows are searched with the SIMD kernels
+        ///
+        /// \param row        Iterator to the beginning of the row
+        /// \param width      Width of the row
+        /// \param background Value of background elements
+        /// \param runs       Runs to append to
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename T>
+        void extract_runs(InputIterator row,
+                          std::size_t width,
+                          iterator_value_type<InputIterator> background,
+                          std::vector<label_run<T>>& runs) {
+            extract_element_runs(row, width, background, runs);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Append the runs of foreground pixels in a packed binary row. Each
+        /// machine word of the row is loaded once and its runs are found
+        /// with count trailing or leading zeros
+        ///
+        /// \param row        Iterator to the beginning of the row
+        /// \param width      Width of the row
+        /// \param background Value of background pixels
+        /// \param runs       Runs to append to
+        //////////////////////////////////////////////////////////////////////
+        template<typename T>
+        void extract_runs(packed_bit_iterator row,
+                          std::size_t width,
+                          bool background,
+                          std::vector<label_run<T>>& runs) {
+            // Rows of a subview do not start on a byte boundary
+            if (static_cast<std::size_t>(row.index()) % row.width() != 0) {
+                extract_element_runs(row, width, background, runs);
+                return;
+            }
+
+            const bit_order order = row.order();
+            const std::size_t y = static_cast<std::size_t>(row.index()) / row.width();
+            const std::uint8_t* bytes = row.data() + y * row.stride();
+            const std::size_t row_bytes = (width + 7) / 8;
+            bool inside = false;
+            std::size_t start = 0;
+
+            for (std::size_t byte = 0; byte < row_bytes; byte += 8) {
+                const std::size_t count = std::min<std::size_t>(8, row_bytes - byte);
+                const std::size_t base = byte * 8;
+                const std::size_t bits = std::min(count * 8, width - base);
+                std::uint64_t word = load_bit_word(bytes + byte, count, order);
+
+                // Set bits are foreground, padding bits are ignored
+                word = mask_bit_word(background ? ~word : word, bits, order);
+
+                for (std::size_t pos = 0; pos < bits;) {
+                    // Find where the next run starts or the current one ends
+                    pos = next_set_bit(inside ? ~word : word, pos, order);
+
+                    if (pos >= bits) {
+                        break;
+                    }
+
+                    if (inside) {
+                        runs.push_back(label_run<T>{ start, base + pos, T(0) });
+                    } else {
+                        start = base + pos;
+                    }
+
+                    inside = !inside;
+                }
+            }
+
+            if (inside) {
+                runs.push_back(label_run<T>{ start, width, T(0) });
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Scan labels one run at a time. Each run gets the label of the
+        /// runs it overlaps in the previous row, so the label equivalences
+        /// only see one entry per run instead of one per element. Nothing is
+        /// written to the label image, the runs are kept for relabel_runs()
+        ///
+        /// Runs are labelled in raster order of their first element, so the
+        /// final labels are identical to the pixel-based scans
+        ///
+        /// \param input        A view of some image data
+        /// \param labels       Label equivalences
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param runs         Receives the runs of all rows
+        /// \param row_runs     Receives the index of the first run of each
+        ///                     row, followed by the total number of runs
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename T>
+        void scan_runs(const array_view<InputIterator>& input,
+                       union_find<T>& labels,
+                       unsigned char connectivity,
+                       iterator_value_type<InputIterator> background,
+                       std::vector<label_run<T>>& runs,
+                       std::vector<std::size_t>& row_runs) {
+            const std::size_t width = input.width();
+            const std::size_t height = input.height();
+
+            // Runs in adjacent rows touch diagonally under 8-connectivity
+            const std::size_t reach = (connectivity == 8 ? 1 : 0);
+
+            runs.clear();
+            row_runs.clear();
+            row_runs.push_back(0);
+
+            for (std::size_t y = 0; y < height; ++y) {
+                extract_runs(input.row_begin(y), width, background, runs);
+                row_runs.push_back(runs.size());
+
+                // Indices into the runs of the previous row
+                std::size_t i = (y > 0 ? row_runs[y - 1] : 0);
+                const std::size_t above_end = (y > 0 ? row_runs[y] : 0);
+
+                for (std::size_t j = row_runs[y]; j < row_runs[y + 1]; ++j) {
+                    label_run<T>& run = runs[j];
+
+                    // Skip runs above that end before this one can touch them
+                    while (i < above_end && runs[i].end + reach <= run.start) {
+                        ++i;
+                    }
+
+                    std::size_t k = i;
+
+                    for (; k < above_end && runs[k].start < run.end + reach; ++k) {
+                        run.label = run.label ? labels.merge(run.label, runs[k].label) : runs[k].label;
+                    }
+
+                    if (!run.label) {
+                        run.label = labels.new_label();
+                    }
+
+                    // The last run above may also touch the next run
+                    if (k > i) {
+                        i = k - 1;
+                    }
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Write the runs to the label image with the given label function
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename T, typename LabelFunction>
+        void write_runs(array_view<RandomAccessIterator>& view,
+                        const std::vector<label_run<T>>& runs,
+                        const std::vector<std::size_t>& row_runs,
+                        LabelFunction label_of) {
+            if (!view.valid()) {
+                throw exception("View is empty");
+            }
+
+            const std::size_t width = view.width();
+
+            for (std::size_t y = 0; y < view.height(); ++y) {
+                const RandomAccessIterator row = view.row_begin(y);
+                std::size_t x = 0;
+
+                for (std::size_t j = row_runs[y]; j < row_runs[y + 1]; ++j) {
+                    const label_run<T>& run = runs[j];
+
+                    std::fill(row + x, row + run.start, T(0));
+                    std::fill(row + run.start, row + run.end, label_of(run, y));
+                    x = run.end;
+                }
+
+                std::fill(row + x, row + width, T(0));
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Relabel all connected components from the runs of scan_runs()
+        ///
+        /// \param view     A view of the label image
+        /// \param labels   Flattened label equivalences
+        /// \param runs     Runs of all rows
+        /// \param row_runs Index of the first run of each row
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        void relabel_runs(array_view<RandomAccessIterator>& view,
+                          const union_find<iterator_value_type<RandomAccessIterator>>& labels,
+                          const std::vector<label_run<iterator_value_type<RandomAccessIterator>>>& runs,
+                          const std::vector<std::size_t>& row_runs) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            write_runs(view, runs, row_runs, [&labels](const label_run<T>& run, std::size_t) {
+                return labels.get(run.label);
+            });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Relabel all connected components from the runs of scan_runs()
+        /// and extract their features
+        ///
+        /// \param view       A view of the label image
+        /// \param labels     Flattened label equivalences
+        /// \param features   Static feature set or runtime extractor_set
+        /// \param components Vector of connected components, or the
+        ///                   rows of a component_table
+        /// \param runs       Runs of all rows
+        /// \param row_runs   Index of the first run of each row
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename Features, typename Components>
+        void relabel_runs(array_view<RandomAccessIterator>& view,
+                          const union_find<iterator_value_type<RandomAccessIterator>>& labels,
+                          const Features& features,
+                          Components& components,
+                          const std::vector<label_run<iterator_value_type<RandomAccessIterator>>>& runs,
+                          const std::vector<std::size_t>& row_runs) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            write_runs(view, runs, row_runs, [&](const label_run<T>& run, std::size_t y) {
+                const T label = labels.get(run.label);
+                features.update_run(run.start, run.end, y, components[label - 1]);
+
+                return label;
+            });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Write the runs as a binary label image, with one for foreground
+        /// elements, e.g. to relabel it with a wider label type
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        void write_run_mask(array_view<RandomAccessIterator>& view,
+                            const std::vector<label_run<iterator_value_type<RandomAccessIterator>>>& runs,
+                            const std::vector<std::size_t>& row_runs) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            write_runs(view, runs, row_runs, [](const label_run<T>&, std::size_t) {
+                return T(1);
+            });
+        }
+    } // detail
+} // cvx
+
+#endif // CVX_RUN_LABEL_HPP
@@ -0,0 +1,365 @@
+#ifndef CVX_SIMD_HPP
+#define CVX_SIMD_HPP
+
+#include "cvx/bit_view.hpp"
+#include "cvx/export.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Find the first element in [first, last[ of a row that is equal
+        /// (find_equal) or not equal (find_not_equal) to a value, comparing
+        /// 16 or 32 elements at a time. The kernel (AVX2, SSE4.1, NEON or
+        /// scalar) is chosen once at runtime from the features of the CPU
+        ///
+        /// \return The index of the element, or last if there is none
+        //////////////////////////////////////////////////////////////////////
+        CVX_EXPORT std::size_t find_equal(const std::uint8_t* row, std::size_t first, std::size_t last, std::uint8_t value);
+        CVX_EXPORT std::size_t find_equal(const std::uint16_t* row, std::size_t first, std::size_t last, std::uint16_t value);
+        CVX_EXPORT std::size_t find_equal(const std::uint32_t* row, std::size_t first, std::size_t last, std::uint32_t value);
+        CVX_EXPORT std::size_t find_equal(const std::uint64_t* row, std::size_t first, std::size_t last, std::uint64_t value);
+        CVX_EXPORT std::size_t find_not_equal(const std::uint8_t* row, std::size_t first, std::size_t last, std::uint8_t value);
+        CVX_EXPORT std::size_t find_not_equal(const std::uint16_t* row, std::size_t first, std::size_t last, std::uint16_t value);
+        CVX_EXPORT std::size_t find_not_equal(const std::uint32_t* row, std::size_t first, std::size_t last, std::uint32_t value);
+        CVX_EXPORT std::size_t find_not_equal(const std::uint64_t* row, std::size_t first, std::size_t last, std::uint64_t value);
+
+        //////////////////////////////////////////////////////////////////////
+        /// Replace each of count labels by its entry in a lookup table, i.e.
+        /// labels[i] = table[labels[i]], without branching on the labels.
+        /// With AVX2 the entries are gathered 8 or 4 at a time. A table of
+        /// 32-bit labels must have fewer than 2^31 entries
+        //////////////////////////////////////////////////////////////////////
+        CVX_EXPORT void lookup_labels(std::uint32_t* labels, std::size_t count, const std::uint32_t* table);
+        CVX_EXPORT void lookup_labels(std::uint64_t* labels, std::size_t count, const std::uint64_t* table);
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return The name of the kernel chosen for this CPU, e.g. "avx2"
+        //////////////////////////////////////////////////////////////////////
+        CVX_EXPORT const char* simd_kernel_name();
+
+        //////////////////////////////////////////////////////////////////////
+        /// True for iterators known to point into contiguous memory, i.e.
+        /// pointers and std::vector iterators
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator,
+                 typename T = typename std::iterator_traits<Iterator>::value_type>
+        struct is_contiguous_iterator
+            : std::integral_constant<bool, std::is_pointer<Iterator>::value ||
+                                           (!std::is_same<T, bool>::value &&
+                                            (std::is_same<Iterator, typename std::vector<T>::iterator>::value ||
+                                             std::is_same<Iterator, typename std::vector<T>::const_iterator>::value))> {};
+
+        //////////////////////////////////////////////////////////////////////
+        /// True if rows of the iterator can be searched with find_equal and
+        /// find_not_equal, i.e. contiguous integers of 1, 2, 4 or 8 bytes
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator,
+                 typename T = typename std::iterator_traits<Iterator>::value_type>
+        struct is_simd_searchable
+            : std::integral_constant<bool, is_contiguous_iterator<Iterator>::value &&
+                                           std::is_integral<T>::value &&
+                                           !std::is_same<T, bool>::value &&
+                                           (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+        //////////////////////////////////////////////////////////////////////
+        /// True if labels of the iterator can be looked up with
+        /// lookup_labels, i.e. contiguous integers of 4 or 8 bytes. Narrower
+        /// labels have tables small enough to stay in cache and are looked
+        /// up inline
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator,
+                 typename T = typename std::iterator_traits<Iterator>::value_type>
+        struct is_simd_gatherable
+            : std::integral_constant<bool, is_simd_searchable<Iterator>::value &&
+                                           (sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+        //////////////////////////////////////////////////////////////////////
+        /// Unsigned integer type with the given size in bytes
+        //////////////////////////////////////////////////////////////////////
+        template<std::size_t Size> struct unsigned_of_size { using type = void; };
+        template<> struct unsigned_of_size<1> { using type = std::uint8_t; };
+        template<> struct unsigned_of_size<2> { using type = std::uint16_t; };
+        template<> struct unsigned_of_size<4> { using type = std::uint32_t; };
+        template<> struct unsigned_of_size<8> { using type = std::uint64_t; };
+
+        // Number of elements searched inline before calling a kernel
+        constexpr std::size_t simd_probe_length = 8;
+
+        template<typename Iterator>
+        std::size_t find_background(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background,
+                                    std::true_type) {
+            using U = typename unsigned_of_size<sizeof(background)>::type;
+
+            // Short stretches are cheaper to search inline than through the
+            // kernel
+            const std::size_t probe = (last - first < simd_probe_length ? last : first + simd_probe_length);
+
+            while (first < probe && !(row[first] == background)) {
+                ++first;
+            }
+
+            if (first < probe || first == last) {
+                return first;
+            }
+
+            return find_equal(reinterpret_cast<const U*>(&*row), first, last, static_cast<U>(background));
+        }
+
+        template<typename Iterator>
+        std::size_t find_background(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background,
+                                    std::false_type) {
+            while (first < last && !(row[first] == background)) {
+                ++first;
+            }
+
+            return first;
+        }
+
+        template<typename Iterator>
+        std::size_t find_foreground(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background,
+                                    std::true_type) {
+            using U = typename unsigned_of_size<sizeof(background)>::type;
+
+            // Short stretches are cheaper to search inline than through the
+            // kernel
+            const std::size_t probe = (last - first < simd_probe_length ? last : first + simd_probe_length);
+
+            while (first < probe && row[first] == background) {
+                ++first;
+            }
+
+            if (first < probe || first == last) {
+                return first;
+            }
+
+            return find_not_equal(reinterpret_cast<const U*>(&*row), first, last, static_cast<U>(background));
+        }
+
+        template<typename Iterator>
+        std::size_t find_foreground(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background,
+                                    std::false_type) {
+            while (first < last && row[first] == background) {
+                ++first;
+            }
+
+            return first;
+        }
+
+        template<typename Iterator>
+        void relabel_span(Iterator first,
+                          std::size_t count,
+                          const typename std::iterator_traits<Iterator>::value_type* table,
+                          std::size_t,
+                          std::false_type) {
+            for (std::size_t i = 0; i < count; ++i) {
+                first[i] = table[static_cast<std::size_t>(first[i])];
+            }
+        }
+
+        template<typename Iterator>
+        void relabel_span(Iterator first,
+                          std::size_t count,
+                          const typename std::iterator_traits<Iterator>::value_type* table,
+                          std::size_t table_size,
+                          std::true_type) {
+            using T = typename std::iterator_traits<Iterator>::value_type;
+            using U = typename unsigned_of_size<sizeof(T)>::type;
+
+            // The 32-bit gathers index the table with signed integers
+            if (sizeof(T) == 4 && table_size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+                relabel_span(first, count, table, table_size, std::false_type());
+                return;
+            }
+
+            lookup_labels(reinterpret_cast<U*>(&*first), count, reinterpret_cast<const U*>(table));
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Find the first background element in [first, last[ of a row.
+        /// Contiguous integer rows are searched with the SIMD kernels, all
+        /// others one element at a time
+        ///
+        /// \param row        Iterator to the beginning of the row
+        /// \param first      Index to start searching from
+        /// \param last       Index to stop searching at
+        /// \param background Value of background elements
+        /// \return The index of the element, or last if there is none
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator>
+        std::size_t find_background(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background) {
+            return find_background(row, first, last, background, is_simd_searchable<Iterator>());
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Find the first foreground element in [first, last[ of a row.
+        /// Contiguous integer rows are searched with the SIMD kernels, all
+        /// others one element at a time
+        ///
+        /// \param row        Iterator to the beginning of the row
+        /// \param first      Index to start searching from
+        /// \param last       Index to stop searching at
+        /// \param background Value of background elements
+        /// \return The index of the element, or last if there is none
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator>
+        std::size_t find_foreground(Iterator row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    typename std::iterator_traits<Iterator>::value_type background) {
+            return find_foreground(row, first, last, background, is_simd_searchable<Iterator>());
+        }
+        //////////////////////////////////////////////////////////////////////
+        /// Replace each label of a span by its entry in a lookup table whose
+        /// first entry is zero, so background elements stay background
+        /// without a branch. Contiguous 32 and 64-bit labels are looked up
+        /// with the SIMD kernels, all others one element at a time
+        ///
+        /// \param first      Iterator to the first label of the span
+        /// \param count      Number of labels in the span
+        /// \param table      Final label of each provisional label
+        /// \param table_size Number of entries in the table
+        //////////////////////////////////////////////////////////////////////
+        template<typename Iterator>
+        void relabel_span(Iterator first,
+                          std::size_t count,
+                          const typename std::iterator_traits<Iterator>::value_type* table,
+                          std::size_t table_size) {
+            relabel_span(first, count, table, table_size, is_simd_gatherable<Iterator>());
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Load up to eight bytes of a packed row into a word, so that the
+        /// first pixel is the least significant bit for bit_order::lsb_first
+        /// and the most significant bit for bit_order::msb_first
+        //////////////////////////////////////////////////////////////////////
+        inline std::uint64_t load_bit_word(const std::uint8_t* bytes, std::size_t count, bit_order order) {
+            std::uint64_t word = 0;
+
+            if (order == bit_order::lsb_first) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    word |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+                }
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    word |= static_cast<std::uint64_t>(bytes[i]) << (56 - 8 * i);
+                }
+            }
+
+            return word;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return The position of the first set bit of a word loaded by
+        ///         load_bit_word() at or after pos, or 64 if there is none
+        //////////////////////////////////////////////////////////////////////
+        inline std::size_t next_set_bit(std::uint64_t word, std::size_t pos, bit_order order) {
+            if (pos >= 64) {
+                return 64;
+            }
+
+            if (order == bit_order::lsb_first) {
+                word >>= pos;
+                return word ? pos + static_cast<std::size_t>(__builtin_ctzll(word)) : 64;
+            }
+
+            word <<= pos;
+            return word ? pos + static_cast<std::size_t>(__builtin_clzll(word)) : 64;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Clear all but the first count pixels of a word loaded by
+        /// load_bit_word()
+        //////////////////////////////////////////////////////////////////////
+        inline std::uint64_t mask_bit_word(std::uint64_t word, std::size_t count, bit_order order) {
+            if (count >= 64) {
+                return word;
+            }
+
+            return word & (order == bit_order::lsb_first ? (std::uint64_t(1) << count) - 1
+                                                         : ~(~std::uint64_t(0) >> count));
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Find the first pixel in [first, last[ of a packed row that has the
+        /// given value, 64 pixels at a time with count trailing or leading
+        /// zeros
+        ///
+        /// \param row   Iterator into the row, first and last are relative
+        ///              to it and must stay within the row
+        /// \param first Index to start searching from
+        /// \param last  Index to stop searching at
+        /// \param value Value of the pixel to find
+        /// \return The index of the pixel, or last if there is none
+        //////////////////////////////////////////////////////////////////////
+        inline std::size_t find_bit(const packed_bit_iterator& row,
+                                    std::size_t first,
+                                    std::size_t last,
+                                    bool value) {
+            const std::size_t width = row.width();
+            const std::size_t y = static_cast<std::size_t>(row.index()) / width;
+            const std::size_t offset = static_cast<std::size_t>(row.index()) % width;
+            const std::uint8_t* bytes = row.data() + y * row.stride();
+            const std::size_t row_bytes = (width + 7) / 8;
+
+            for (std::size_t x = first + offset; x < last + offset;) {
+                const std::size_t byte = x / 8;
+                const std::size_t shift = x % 8;
+                const std::size_t count = std::min<std::size_t>(8, row_bytes - byte);
+                const std::size_t n = std::min(count * 8, last + offset - byte * 8);
+                std::uint64_t word = load_bit_word(bytes + byte, count, row.order());
+
+                if (!value) {
+                    word = ~word;
+                }
+
+                const std::size_t pos = next_set_bit(mask_bit_word(word, n, row.order()), shift, row.order());
+
+                if (pos < n) {
+                    return byte * 8 + pos - offset;
+                }
+
+                x = byte * 8 + n;
+            }
+
+            return last;
+        }
+
+        inline std::size_t find_background(const packed_bit_iterator& row,
+                                           std::size_t first,
+                                           std::size_t last,
+                                           bool background) {
+            return find_bit(row, first, last, background);
+        }
+
+        inline std::size_t find_foreground(const packed_bit_iterator& row,
+                                           std::size_t first,
+                                           std::size_t last,
+                                           bool background) {
+            return find_bit(row, first, last, !background);
+        }
+    } // detail
+} // cvx
+
+#endif // CVX_SIMD_HPP
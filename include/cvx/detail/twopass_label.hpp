@@ -2,112 +2,205 @@
 #define CVX_TWOPASS_LABEL_HPP
 
 #include "cvx/array_view.hpp"
+#include "cvx/component_table.hpp"
 #include "cvx/connected_component.hpp"
 #include "cvx/exception.hpp"
+#include "cvx/features.hpp"
+#include "cvx/label_stats.hpp"
 #include "cvx/union_find.hpp"
+#include "cvx/label_engine.hpp"
 #include "cvx/utils.hpp"
+#include "cvx/detail/block_label.hpp"
 #include "cvx/detail/extractor.hpp"
+#include "cvx/detail/run_label.hpp"
+#include "cvx/detail/simd.hpp"
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace cvx {
-    template<typename Iterator>
-    using iterator_value_type = typename std::iterator_traits<Iterator>::value_type;
-
     namespace detail {
         //////////////////////////////////////////////////////////////////////
-        /// Scan labels using 4-connectivity
+        /// The next wider label type to fall back to when T runs out of
+        /// provisional labels, or void if there is none
+        //////////////////////////////////////////////////////////////////////
+        template<typename T>
+        struct wider_label {
+            using type = typename std::conditional<(sizeof(T) < sizeof(std::uint32_t)),
+                                                   std::uint32_t,
+                                                   typename std::conditional<(sizeof(T) < sizeof(std::uint64_t)),
+                                                                             std::uint64_t,
+                                                                             void>::type>::type;
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// Storage used by a two-pass labelling that can be kept between
+        /// calls to avoid reallocating it
+        //////////////////////////////////////////////////////////////////////
+        template<typename T>
+        struct two_pass_scratch {
+            union_find<T> labels;
+            std::vector<T> order;
+            std::vector<connected_component> components;
+            std::vector<label_run<T>> runs;
+            std::vector<std::size_t> row_runs;
+            label_stats* stats = nullptr;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Clear the contents but keep all storage
+            //////////////////////////////////////////////////////////////////////
+            void reset() {
+                labels.reset();
+                components.clear();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of bytes held by the scratch space
+            //////////////////////////////////////////////////////////////////////
+            std::size_t memory() const noexcept {
+                return labels.capacity() * sizeof(T) +
+                       order.capacity() * sizeof(T) +
+                       components.capacity() * sizeof(connected_component) +
+                       runs.capacity() * sizeof(label_run<T>) +
+                       row_runs.capacity() * sizeof(std::size_t);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Record the counters of the last labelling into the attached
+            /// statistics, if any
+            //////////////////////////////////////////////////////////////////////
+            void record(std::size_t component_count) const {
+                if (stats) {
+                    stats->provisional_labels = labels.size() - 1;
+                    stats->merges             = labels.merge_count();
+                    stats->compression_steps  = labels.compression_steps();
+                    stats->peak_scratch_bytes = memory();
+                    stats->components         = component_count;
+                }
+            }
+        };
+
+        template<typename RandomAccessIterator>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        unsigned char connectivity,
+                                        label_engine engine);
+
+        template<typename RandomAccessIterator, typename OutputIterator, typename Features>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        OutputIterator out,
+                                        unsigned char connectivity,
+                                        const Features& features,
+                                        label_engine engine);
+
+        //////////////////////////////////////////////////////////////////////
+        /// Scan labels using 4-connectivity. Elements are classified from
+        /// the input, while neighbours are read back from the labels already
+        /// written to the output, where zero is background
+        /// Stretches of background are skipped with find_foreground(), which
+        /// searches contiguous integer rows with SIMD
         ///
-        /// \param view       A view of some image data
+        /// \param input      A view of some image data
+        /// \param output     A view of the label image, may be the same as
+        ///                   input
         /// \param labels     Label equivalences
         /// \param background Value of background elements
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator>
-        void scan_labels4(array_view<RandomAccessIterator>& view,
-                          union_find<iterator_value_type<RandomAccessIterator>>& labels,
-                          iterator_value_type<RandomAccessIterator> background) {
-            using U = iterator_value_type<RandomAccessIterator>;
-            U label_count = 1;
+        template<typename InputIterator, typename LabelIterator>
+        void scan_labels4(const array_view<InputIterator>& input,
+                          array_view<LabelIterator>& output,
+                          union_find<iterator_value_type<LabelIterator>>& labels,
+                          iterator_value_type<InputIterator> background) {
+            using U = iterator_value_type<LabelIterator>;
+            const std::size_t width = output.width();
 
             //////////////////////////////////////////////////////////////////////
             // NOTE: We do some loop unrolling below which increases the
             //       complexity of the code, but removes a lot of unnessary
-            //       boundary checks.
+            //       boundary checks. Rows are walked through unchecked row
+            //       iterators, so the inner loops only index into them
             //////////////////////////////////////////////////////////////////////
-            RandomAccessIterator row = view.begin();
+            {
+                const InputIterator in = input.row_begin(0);
+                const LabelIterator row = output.row_begin(0);
 
-            // Examine the first element separately
-            U& e = *row++;
-
-            if (e == background) {
-                e = 0;
-            } else {
-                e = label_count;
-                labels.push_back(label_count++);
-            }
+                // Examine the first element separately
+                U& e = row[0];
 
-            // Scan the first line separately to avoid bounds checks in the remaining lines
-            for (std::size_t x = 1; x < view.width(); ++x, ++row) {
-                U& e = *row;
-
-                if (e == background) {
+                if (in[0] == background) {
                     e = 0;
                 } else {
-                    U d = *(row - 1);
+                    e = labels.new_label();
+                }
 
-                    if (d != background) {
-                        e = d;
+                // Scan the first line separately to avoid bounds checks in the remaining lines
+                for (std::size_t x = 1; x < width; ++x) {
+                    U& e = row[x];
+
+                    if (in[x] == background) {
+                        e = 0;
                     } else {
-                        e = label_count;
-                        labels.push_back(label_count++);
+                        U d = row[x - 1];
+
+                        if (d) {
+                            e = d;
+                        } else {
+                            e = labels.new_label();
+                        }
                     }
                 }
             }
 
             // Scan the rest of the lines
-            for (std::size_t y = 1; y < view.height(); ++y) {
+            for (std::size_t y = 1; y < output.height(); ++y) {
+                const InputIterator in = input.row_begin(y);
+                const LabelIterator row = output.row_begin(y);
+                const LabelIterator above = output.row_begin(y - 1);
+
                 // Check the left-most element of each row manually to reduce total boundary checks
-                U& e = *row;
+                U& e = row[0];
 
-                if (e == background) {
+                if (in[0] == background) {
                     e = 0;
                 } else {
-                    U b = *(row - view.width());
+                    U b = above[0];
 
-                    if (b != background) {
+                    if (b) {
                         e = b;
                     } else {
-                        e = label_count;
-                        labels.push_back(label_count++);
+                        e = labels.new_label();
                     }
                 }
 
-                ++row;
+                for (std::size_t x = 1; x < width; ++x) {
+                    U& e = row[x];
 
-                for (std::size_t x = 1; x < view.width(); ++x, ++row) {
-                    U& e = *row;
+                    if (in[x] == background) {
+                        // Skip the whole stretch of background at once
+                        const std::size_t next = find_foreground(in, x, width, background);
 
-                    if (e == background) {
-                        e = 0;
+                        std::fill(row + x, row + next, U(0));
+                        x = next - 1;
                     } else {
-                        U b = *(row - view.width());
+                        U b = above[x];
 
-                        if (b != background) {
-                            U d = *(row - 1);
+                        if (b) {
+                            U d = row[x - 1];
 
-                            if (d != background) {
+                            if (d) {
                                 e = labels.merge(b, d);
                             } else {
                                 e = b;
                             }
                         } else {
-                            U d = *(row - 1);
+                            U d = row[x - 1];
 
-                            if (d != background) {
+                            if (d) {
                                 e = d;
                             } else {
-                                e = label_count;
-                                labels.push_back(label_count++);
+                                e = labels.new_label();
                             }
                         }
                     }
@@ -116,93 +209,118 @@ namespace cvx {
         }
 
         //////////////////////////////////////////////////////////////////////
-        /// Scan labels using 8-connectivity
+        /// Scan labels using 8-connectivity. Elements are classified from
+        /// the input, while neighbours are read back from the labels already
+        /// written to the output, where zero is background
+        /// Stretches of background are skipped with find_foreground(), which
+        /// searches contiguous integer rows with SIMD
         ///
-        /// \param view       A view of some image data
+        /// \param input      A view of some image data
+        /// \param output     A view of the label image, may be the same as
+        ///                   input
         /// \param labels     Label equivalences
         /// \param background Value of background elements
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator>
-        void scan_labels8(array_view<RandomAccessIterator>& view,
-                          union_find<iterator_value_type<RandomAccessIterator>>& labels,
-                          iterator_value_type<RandomAccessIterator> background) {
-            using U = iterator_value_type<RandomAccessIterator>;
-            U label_count = 1;
+        template<typename InputIterator, typename LabelIterator>
+        void scan_labels8(const array_view<InputIterator>& input,
+                          array_view<LabelIterator>& output,
+                          union_find<iterator_value_type<LabelIterator>>& labels,
+                          iterator_value_type<InputIterator> background) {
+            // A single column has no diagonal neighbours, and the unrolled
+            // borders below assume at least two columns
+            if (output.width() == 1) {
+                scan_labels4(input, output, labels, background);
+                return;
+            }
+
+            using U = iterator_value_type<LabelIterator>;
+            const std::size_t width = output.width();
 
             //////////////////////////////////////////////////////////////////////
             // NOTE: We do some loop unrolling below which increases the
             //       complexity of the code, but removes a lot of boundary checks
             //////////////////////////////////////////////////////////////////////
-            // Examine the first element separately
-            U& e = view(0, 0);
+            {
+                const InputIterator in = input.row_begin(0);
+                const LabelIterator row = output.row_begin(0);
 
-            if (e == background) {
-                e = 0;
-            } else {
-                e = label_count;
-                labels.push_back(label_count++);
-            }
+                // Examine the first element separately
+                U& e = row[0];
 
-            // Scan the first line separately to avoid bounds checks in the remaining lines
-            for (std::size_t x = 1; x < view.width(); ++x) {
-                U& e = view(0, x);
-
-                if (e == background) {
+                if (in[0] == background) {
                     e = 0;
                 } else {
-                    U d = view(0, x - 1);
+                    e = labels.new_label();
+                }
+
+                // Scan the first line separately to avoid bounds checks in the remaining lines
+                for (std::size_t x = 1; x < width; ++x) {
+                    U& e = row[x];
 
-                    if (d) {
-                        e = d;
+                    if (in[x] == background) {
+                        e = 0;
                     } else {
-                        e = label_count;
-                        labels.push_back(label_count++);
+                        U d = row[x - 1];
+
+                        if (d) {
+                            e = d;
+                        } else {
+                            e = labels.new_label();
+                        }
                     }
                 }
             }
 
-            for (std::size_t y = 1; y < view.height(); ++y) {
+            for (std::size_t y = 1; y < output.height(); ++y) {
+                const InputIterator in = input.row_begin(y);
+                const LabelIterator row = output.row_begin(y);
+                const LabelIterator above = output.row_begin(y - 1);
+
                 // Check the left-most element of each row manually to reduce total boundary checks
-                U& e = view(y, 0);
+                U& e = row[0];
 
-                if (e == background) {
+                if (in[0] == background) {
                     e = 0;
                 } else {
-                    U b = view(y - 1, 0);
+                    U b = above[0];
                     
                     if (b) {
                         e = b;
                     } else {
-                        U c = view(y - 1, 1);
+                        U c = above[1];
 
                         if (c) {
                             e = c;
                         } else {
-                            e = label_count;
-                            labels.push_back(label_count++);
+                            e = labels.new_label();
                         }
                     }
                 }
                 
-                for (std::size_t x = 1; x < view.width() - 1; ++x) {
-                    U& e = view(y, x);
+                for (std::size_t x = 1; x < width - 1; ++x) {
+                    U& e = row[x];
 
-                    if (e == background) {
-                        e = 0;
+                    if (in[x] == background) {
+                        // Skip the whole stretch of background at once, but
+                        // leave the right-most element to the code below
+                        const std::size_t next = find_foreground(in, x, width - 1, background);
+
+                        std::fill(row + x, row + next, U(0));
+                        x = next - 1;
                     } else {
-                        U b = view(y - 1, x);
+                        U b = above[x];
 
                         if (b) {
                             e = b;
                         } else {
-                            U c = view(y - 1, x + 1);
-                            U a = view(y - 1, x - 1);
+                            U c = above[x + 1];
+                            U a = above[x - 1];
 
                             if (c) {
                                 if (a) {
                                     e = labels.merge(a, c);
                                 } else {
-                                    U d = view(y, x - 1);
+                                    U d = row[x - 1];
 
                                     if (d) {
                                         e = labels.merge(c, d);
@@ -214,13 +332,12 @@ namespace cvx {
                                 if (a) {
                                     e = a;
                                 } else {
-                                    U d = view(y, x - 1);
+                                    U d = row[x - 1];
 
                                     if (d) {
                                         e = d;
                                     } else {
-                                        e = label_count;
-                                        labels.push_back(label_count++);
+                                        e = labels.new_label();
                                     }
                                 }
                             }
@@ -230,28 +347,28 @@ namespace cvx {
 
                 // Check the right-most element of each row manually to reduce total boundary checks
                 // (Note: Not necessary for 4-connectivity)
-                std::size_t x = view.width() - 1;
-                U& f = view(y, x);
-                U b = view(y - 1, x);
+                std::size_t x = width - 1;
+                U& f = row[x];
 
-                if (f == background) {
+                if (in[x] == background) {
                     f = 0;
                 } else {
+                    U b = above[x];
+
                     if (b) {
                         f = b;
                     } else {
-                        U a = view(y - 1, x - 1);
+                        U a = above[x - 1];
 
                         if (a) {
                             f = a;
                         } else {
-                            U d = view(y, x - 1);
+                            U d = row[x - 1];
 
                             if (d) {
                                 f = d;
                             } else {
-                                f = label_count;
-                                labels.push_back(label_count++);
+                                f = labels.new_label();
                             }
                         }
                     }
@@ -262,40 +379,36 @@ namespace cvx {
         //////////////////////////////////////////////////////////////////////
         /// Relabel all connected components from a set of label equivalences
         ///
-        /// \param view   A view of some image data
+        /// \param view   A view of the label image
         /// \param labels Flattened label equivalences
-        /// \param background Value of background elements
         //////////////////////////////////////////////////////////////////////
         template<typename RandomAccessIterator>
         void relabel(array_view<RandomAccessIterator>& view,
-                     const union_find<iterator_value_type<RandomAccessIterator>>& labels,
-                     iterator_value_type<RandomAccessIterator> background) {
+                     const union_find<iterator_value_type<RandomAccessIterator>>& labels) {
             if (!view.valid() || labels.empty()) {
                 throw exception("No data");
             }
 
-            for (auto& p : view) {
-                if (p) {
-                    p = labels.get(p);
-                }
-            }
+            for_each_span(view, [&labels](RandomAccessIterator first, std::size_t count) {
+                relabel_span(first, count, labels.data(), labels.size());
+            });
         }
 
         //////////////////////////////////////////////////////////////////////
         /// Relabel all connected components from a set of label equivalences
+        /// and extract their features
         ///
-        /// \param view       A view of some image data
+        /// \param view       A view of the label image
         /// \param labels     Flattened label equivalences
-        /// \param extractors Vector of feature extractors
-        /// \param components Vector of connected components
-        /// \param background Value of background elements
+        /// \param features   Static feature set or runtime extractor_set
+        /// \param components Vector of connected components, or the
+        ///                   rows of a component_table
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator, typename Container>
+        template<typename RandomAccessIterator, typename Features, typename Components>
         void relabel(array_view<RandomAccessIterator>& view,
                      const union_find<iterator_value_type<RandomAccessIterator>>& labels,
-                     iterator_value_type<RandomAccessIterator> background,
-                     const Container& extractors,
-                     std::vector<connected_component>& components) {
+                     const Features& features,
+                     Components& components) {
             using T = iterator_value_type<RandomAccessIterator>;
 
             if (!view.valid()) {
@@ -303,101 +416,619 @@ namespace cvx {
             }
 
             for (std::size_t y = 0; y < view.height(); ++y) {
+                const RandomAccessIterator row = view.row_begin(y);
+
+                // Relabel the row first, so the lookups do not wait on the
+                // branches of the feature updates
+                relabel_span(row, view.width(), labels.data(), labels.size());
+
                 for (std::size_t x = 0; x < view.width(); ++x) {
-                    T& e = view(y, x);
+                    const T e = row[x];
 
                     if (e) {
-                        e = labels.get(e);
-
-                        for (auto& ex : extractors) {
-                            ex->update(x, y, components[e - 1]);
-                        }
+                        features.update(x, y, components[e - 1]);
                     }
                 }
             }
         }
 
         //////////////////////////////////////////////////////////////////////
+        /// Do the initial scan of connected components with the given engine
         ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image, may be the same as
+        ///                     input
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param engine       Scan strategy to use
+        /// \param scratch      Label equivalences and runs to fill
+        /// \return The scan strategy that was used, the block-based scan
+        ///         only supports 8-connectivity
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator>
-        std::size_t two_pass_label(array_view<RandomAccessIterator>& view,
+        template<typename InputIterator, typename LabelIterator>
+        label_engine scan_labels(const array_view<InputIterator>& input,
+                                 array_view<LabelIterator>& output,
+                                 unsigned char connectivity,
+                                 iterator_value_type<InputIterator> background,
+                                 label_engine engine,
+                                 two_pass_scratch<iterator_value_type<LabelIterator>>& scratch) {
+            if (engine == label_engine::run) {
+                scan_runs(input, scratch.labels, connectivity, background, scratch.runs, scratch.row_runs);
+                return label_engine::run;
+            } else if (connectivity == 4) {
+                scan_labels4(input, output, scratch.labels, background);
+            } else if (engine == label_engine::block) {
+                scan_blocks8(input, output, scratch.labels, background);
+                return label_engine::block;
+            } else {
+                scan_labels8(input, output, scratch.labels, background);
+            }
+
+            return label_engine::pixel;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Leave a label image where foreground elements are non-zero after
+        /// a scan whose labels overflowed, so it can be labelled again with
+        /// a wider label type
+        //////////////////////////////////////////////////////////////////////
+        template<typename LabelIterator>
+        void prepare_wide_label(array_view<LabelIterator>& output,
+                                label_engine scanned,
+                                const two_pass_scratch<iterator_value_type<LabelIterator>>& scratch) {
+            // The run-based scan does not write provisional labels
+            if (scanned == label_engine::run) {
+                write_run_mask(output, scratch.runs, scratch.row_runs);
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output. Both views may refer to the same data to label
+        /// in place
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param engine       Scan strategy to use
+        /// \param scratch      Reusable label equivalences and tables
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t two_pass_label(const array_view<InputIterator>& input,
+                                   array_view<LabelIterator>& output,
                                    unsigned char connectivity,
-                                   iterator_value_type<RandomAccessIterator> background) { 
-            using T = iterator_value_type<RandomAccessIterator>;
-            union_find<T> labels;
+                                   iterator_value_type<InputIterator> background,
+                                   label_engine engine,
+                                   two_pass_scratch<iterator_value_type<LabelIterator>>& scratch) { 
+            auto& labels = scratch.labels;
+            scratch.reset();
+            CVX_STATS(if (scratch.stats) scratch.stats->reset();)
+            CVX_STATS(stats_timer timer(scratch.stats);)
 
             // 1. Do initial scan of connected components
-            if (connectivity == 4) {
-                scan_labels4(view, labels, background);
-            } else {
-                scan_labels8(view, labels, background);
+            const label_engine scanned = scan_labels(input, output, connectivity, background, engine, scratch);
+            CVX_STATS(timer.lap(&label_stats::scan_ms);)
+
+            if (labels.overflow()) {
+                prepare_wide_label(output, scanned, scratch);
+
+                const std::size_t label_count = wide_two_pass_label(output, connectivity, engine);
+                CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+                CVX_STATS(scratch.record(label_count);)
+
+                return label_count;
             }
 
             // 2. Compress all labels so they point to their root
             labels.flatten();
+            CVX_STATS(timer.lap(&label_stats::flatten_ms);)
 
             // 3. Relabel all connected components with final labels
-            relabel(view, labels, background);
+            if (scanned == label_engine::block) {
+                relabel_blocks(output, labels, scratch.order);
+            } else if (scanned == label_engine::run) {
+                relabel_runs(output, labels, scratch.runs, scratch.row_runs);
+            } else {
+                relabel(output, labels);
+            }
+
+            CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+            CVX_STATS(scratch.record(labels.label_count());)
 
             return labels.label_count();
         }
-        
+
         //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output. Both views may refer to the same data to label
+        /// in place
         ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param engine       Scan strategy to use
+        /// \return The number of connected components found
         //////////////////////////////////////////////////////////////////////
-        template<typename RandomAccessIterator,
-                 typename OutputIterator>
-        std::size_t two_pass_label(array_view<RandomAccessIterator>& view,
-                                   OutputIterator out,
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t two_pass_label(const array_view<InputIterator>& input,
+                                   array_view<LabelIterator>& output,
                                    unsigned char connectivity,
-                                   iterator_value_type<RandomAccessIterator> background,
-                                   const feature_flag& flags) { 
-            std::vector<std::shared_ptr<extractor>> extractors;
-            make_extractors_from_flags(flags,
-                                       std::back_inserter(extractors));
+                                   iterator_value_type<InputIterator> background,
+                                   label_engine engine) { 
+            two_pass_scratch<iterator_value_type<LabelIterator>> scratch;
 
-            using T = iterator_value_type<RandomAccessIterator>;
-            union_find<T> labels;
+            return two_pass_label(input, output, connectivity, background, engine, scratch);
+        }
+        
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output and extract the features of each component into
+        /// the components of the scratch space
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param features     Static feature set or runtime extractor_set
+        /// \param engine       Scan strategy to use
+        /// \param scratch      Reusable label equivalences, tables and
+        ///                     components
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename Features>
+        std::size_t two_pass_label_components(const array_view<InputIterator>& input,
+                                              array_view<LabelIterator>& output,
+                                              unsigned char connectivity,
+                                              iterator_value_type<InputIterator> background,
+                                              const Features& features,
+                                              label_engine engine,
+                                              two_pass_scratch<iterator_value_type<LabelIterator>>& scratch) { 
+            auto& labels = scratch.labels;
+            auto& components = scratch.components;
+            scratch.reset();
+            CVX_STATS(if (scratch.stats) scratch.stats->reset();)
+            CVX_STATS(stats_timer timer(scratch.stats);)
 
             // 1. Do initial scan of connected components
-            if (connectivity == 4) {
-                scan_labels4(view, labels, background);
-            } else {
-                scan_labels8(view, labels, background);
+            const label_engine scanned = scan_labels(input, output, connectivity, background, engine, scratch);
+            CVX_STATS(timer.lap(&label_stats::scan_ms);)
+
+            if (labels.overflow()) {
+                prepare_wide_label(output, scanned, scratch);
+
+                const std::size_t label_count = wide_two_pass_label(output,
+                                                                    std::back_inserter(components),
+                                                                    connectivity,
+                                                                    features,
+                                                                    engine);
+                CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+                CVX_STATS(scratch.record(label_count);)
+
+                return label_count;
             }
 
             // 2. Compress all labels so they point to their root
             labels.flatten();
-            
-            std::vector<connected_component> components;
-            components.reserve(labels.label_count());
+            CVX_STATS(timer.lap(&label_stats::flatten_ms);)
 
             // Set labels
             for (size_t i = 0; i < labels.label_count(); ++i) {
                 components.emplace_back(i + 1);
             }
 
-            for (auto& ex : extractors) {
-                for (auto& cc : components) {
-                    ex->initialise(cc);
-                }
+            for (auto& cc : components) {
+                features.initialise(cc);
             }
 
             // 3. Relabel all connected components with final labels
-            relabel(view, labels, background, extractors, components);
+            if (scanned == label_engine::block) {
+                relabel_blocks(output, labels, features, components, scratch.order);
+            } else if (scanned == label_engine::run) {
+                relabel_runs(output, labels, features, components, scratch.runs, scratch.row_runs);
+            } else {
+                relabel(output, labels, features, components);
+            }
+
+            CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+
+            for (auto& cc : components) {
+                features.finalise(cc);
+            }
+
+            CVX_STATS(timer.lap(&label_stats::finalise_ms);)
+            CVX_STATS(scratch.record(labels.label_count());)
+
+            return labels.label_count();
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Fill a component table from a view of final labels
+        ///
+        /// \param view        A view of the label image
+        /// \param label_count Number of connected components
+        /// \param table       Receives the features of all components
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        void fill_component_table(array_view<RandomAccessIterator>& view,
+                                  std::size_t label_count,
+                                  component_table& table) {
+            const table_features features;
+            table_rows rows{ table };
+
+            table_features::initialise(table, label_count);
 
-            for (auto& ex : extractors) {
-                for (auto& cc : components) {
-                    ex->finalise(cc);
+            for (std::size_t y = 0; y < view.height(); ++y) {
+                const RandomAccessIterator row = view.row_begin(y);
+
+                for (std::size_t x = 0; x < view.width(); ++x) {
+                    const iterator_value_type<RandomAccessIterator> e = row[x];
+
+                    if (e) {
+                        features.update(x, y, rows[e - 1]);
+                    }
                 }
             }
 
+            table_features::finalise(table);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output and extract the area, centroid and bounding box
+        /// of each component directly into the arrays of a component table
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param engine       Scan strategy to use
+        /// \param scratch      Reusable label equivalences and tables
+        /// \param table        Receives the features of all components
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t two_pass_label_table(const array_view<InputIterator>& input,
+                                         array_view<LabelIterator>& output,
+                                         unsigned char connectivity,
+                                         iterator_value_type<InputIterator> background,
+                                         label_engine engine,
+                                         two_pass_scratch<iterator_value_type<LabelIterator>>& scratch,
+                                         component_table& table) {
+            auto& labels = scratch.labels;
+            scratch.reset();
+            CVX_STATS(if (scratch.stats) scratch.stats->reset();)
+            CVX_STATS(stats_timer timer(scratch.stats);)
+
+            // 1. Do initial scan of connected components
+            const label_engine scanned = scan_labels(input, output, connectivity, background, engine, scratch);
+            CVX_STATS(timer.lap(&label_stats::scan_ms);)
+
+            if (labels.overflow()) {
+                prepare_wide_label(output, scanned, scratch);
+
+                const std::size_t label_count = wide_two_pass_label(output, connectivity, engine);
+                fill_component_table(output, label_count, table);
+                CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+                CVX_STATS(scratch.record(label_count);)
+
+                return label_count;
+            }
+
+            // 2. Compress all labels so they point to their root
+            labels.flatten();
+            CVX_STATS(timer.lap(&label_stats::flatten_ms);)
+
+            const table_features features;
+            table_rows rows{ table };
+
+            table_features::initialise(table, labels.label_count());
+
+            // 3. Relabel all connected components with final labels
+            if (scanned == label_engine::block) {
+                relabel_blocks(output, labels, features, rows, scratch.order);
+            } else if (scanned == label_engine::run) {
+                relabel_runs(output, labels, features, rows, scratch.runs, scratch.row_runs);
+            } else {
+                relabel(output, labels, features, rows);
+            }
+
+            CVX_STATS(timer.lap(&label_stats::relabel_ms);)
+            table_features::finalise(table);
+            CVX_STATS(timer.lap(&label_stats::finalise_ms);)
+            CVX_STATS(scratch.record(labels.label_count());)
+
+            return labels.label_count();
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Calls two_pass_label_components with a static feature set
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        struct two_pass_label_visitor {
+            const array_view<InputIterator>& input;
+            array_view<LabelIterator>& output;
+            unsigned char connectivity;
+            iterator_value_type<InputIterator> background;
+            label_engine engine;
+            two_pass_scratch<iterator_value_type<LabelIterator>>& scratch;
+
+            template<typename Features>
+            std::size_t operator()(const Features& features) {
+                return two_pass_label_components(input, output, connectivity, background, features, engine, scratch);
+            }
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output and extract the features given by the flags into
+        /// the components of the scratch space. Combinations of area,
+        /// centroid and bounding box are extracted by precompiled static
+        /// feature sets, all other features by the given extractors
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param flags        Bitflag of the component features to extract
+        /// \param extractors   Extractors for flags without a static set
+        /// \param engine       Scan strategy to use
+        /// \param scratch      Reusable label equivalences, tables and
+        ///                     components
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator, typename LabelIterator>
+        std::size_t two_pass_label_components(const array_view<InputIterator>& input,
+                                              array_view<LabelIterator>& output,
+                                              unsigned char connectivity,
+                                              iterator_value_type<InputIterator> background,
+                                              const feature_flag& flags,
+                                              const extractor_set& extractors,
+                                              label_engine engine,
+                                              two_pass_scratch<iterator_value_type<LabelIterator>>& scratch) {
+            if (has_static_features(flags)) {
+                two_pass_label_visitor<InputIterator, LabelIterator> visitor{
+                    input, output, connectivity, background, engine, scratch
+                };
+
+                return visit_static_features(flags, visitor);
+            }
+
+            return two_pass_label_components(input, output, connectivity, background, extractors, engine, scratch);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output and extract the features of each component. Both
+        /// views may refer to the same data to label in place
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param out          Output iterator for storing connected
+        ///                     components, e.g. a std::vector<>
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param features     Static feature set or runtime extractor_set
+        /// \param engine       Scan strategy to use
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator,
+                 typename Features>
+        std::size_t two_pass_label(const array_view<InputIterator>& input,
+                                   array_view<LabelIterator>& output,
+                                   OutputIterator out,
+                                   unsigned char connectivity,
+                                   iterator_value_type<InputIterator> background,
+                                   const Features& features,
+                                   label_engine engine) { 
+            two_pass_scratch<iterator_value_type<LabelIterator>> scratch;
+            const std::size_t label_count = two_pass_label_components(input,
+                                                                      output,
+                                                                      connectivity,
+                                                                      background,
+                                                                      features,
+                                                                      engine,
+                                                                      scratch);
+
+            std::move(scratch.components.begin(),
+                      scratch.components.end(),
+                      out);
+
+            return label_count;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Label the elements of the input that differ from the background
+        /// into the output and extract the features given by the flags
+        ///
+        /// \param input        A view of some image data
+        /// \param output       A view of the label image
+        /// \param out          Output iterator for storing connected
+        ///                     components, e.g. a std::vector<>
+        /// \param connectivity Neighbourhood connectivity (4 or 8)
+        /// \param background   Value of background elements
+        /// \param flags        Bitflag of the component features to extract
+        /// \param engine       Scan strategy to use
+        /// \return The number of connected components found
+        //////////////////////////////////////////////////////////////////////
+        template<typename InputIterator,
+                 typename LabelIterator,
+                 typename OutputIterator>
+        std::size_t two_pass_label(const array_view<InputIterator>& input,
+                                   array_view<LabelIterator>& output,
+                                   OutputIterator out,
+                                   unsigned char connectivity,
+                                   iterator_value_type<InputIterator> background,
+                                   const feature_flag& flags,
+                                   label_engine engine) {
+            two_pass_scratch<iterator_value_type<LabelIterator>> scratch;
+            const std::size_t label_count = two_pass_label_components(input,
+                                                                      output,
+                                                                      connectivity,
+                                                                      background,
+                                                                      flags,
+                                                                      extractor_set(flags),
+                                                                      engine,
+                                                                      scratch);
+
+            std::move(scratch.components.begin(),
+                      scratch.components.end(),
+                      out);
+
+            return label_count;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Copy the foreground of a scanned view into a binary buffer of a
+        /// wider label type. The scan leaves every foreground element
+        /// non-zero, even if its provisional labels overflowed
+        ///
+        /// \param view   A view of scanned image data
+        /// \param labels Storage for the wide labels
+        /// \return A view of the wide labels
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename W>
+        array_view<typename std::vector<W>::iterator> make_wide_view(array_view<RandomAccessIterator>& view,
+                                                                    std::vector<W>& labels) {
+            labels.resize(view.size());
+
+            array_view<typename std::vector<W>::iterator> wide_view(labels.begin(),
+                                                                    labels.end(),
+                                                                    view.width(),
+                                                                    view.height());
+
+            transform_view(view, wide_view, [](iterator_value_type<RandomAccessIterator> e) {
+                return e ? W(1) : W(0);
+            });
+
+            return wide_view;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Copy final wide labels back into a view
+        ///
+        /// \param view        A view of image data
+        /// \param labels      Final wide labels
+        /// \param label_count Number of connected components
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator, typename W>
+        void copy_wide_labels(array_view<RandomAccessIterator>& view,
+                              const std::vector<W>& labels,
+                              std::size_t label_count) {
+            using T = iterator_value_type<RandomAccessIterator>;
+
+            if (label_count > static_cast<std::size_t>(std::numeric_limits<T>::max())) {
+                throw exception("Too many connected components for the label type");
+            }
+
+            const array_view<typename std::vector<W>::const_iterator> wide_view(labels.cbegin(),
+                                                                                labels.cend(),
+                                                                                view.width(),
+                                                                                view.height());
+
+            transform_view(wide_view, view, [](W e) {
+                return static_cast<T>(e);
+            });
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Relabel a view whose provisional labels overflowed its own type
+        /// with the next wider label type. Throws if there is no wider type
+        /// or if the final labels do not fit either
+        //////////////////////////////////////////////////////////////////////
+        template<typename RandomAccessIterator>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>&,
+                                        unsigned char,
+                                        label_engine,
+                                        std::false_type) {
+            throw exception("Too many connected components for the label type");
+        }
+
+        template<typename RandomAccessIterator>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        unsigned char connectivity,
+                                        label_engine engine,
+                                        std::true_type) {
+            using W = typename wider_label<iterator_value_type<RandomAccessIterator>>::type;
+            std::vector<W> labels;
+            auto wide_view = make_wide_view(view, labels);
+
+            const std::size_t label_count = two_pass_label(wide_view, wide_view, connectivity, W(0), engine);
+            copy_wide_labels(view, labels, label_count);
+
+            return label_count;
+        }
+
+        template<typename RandomAccessIterator>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        unsigned char connectivity,
+                                        label_engine engine) {
+            using W = typename wider_label<iterator_value_type<RandomAccessIterator>>::type;
+
+            return wide_two_pass_label(view,
+                                       connectivity,
+                                       engine,
+                                       std::integral_constant<bool, !std::is_void<W>::value>());
+        }
+
+        template<typename RandomAccessIterator, typename OutputIterator, typename Features>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>&,
+                                        OutputIterator,
+                                        unsigned char,
+                                        const Features&,
+                                        label_engine,
+                                        std::false_type) {
+            throw exception("Too many connected components for the label type");
+        }
+
+        template<typename RandomAccessIterator, typename OutputIterator, typename Features>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        OutputIterator out,
+                                        unsigned char connectivity,
+                                        const Features& features,
+                                        label_engine engine,
+                                        std::true_type) {
+            using W = typename wider_label<iterator_value_type<RandomAccessIterator>>::type;
+            std::vector<W> labels;
+            auto wide_view = make_wide_view(view, labels);
+
+            std::vector<connected_component> components;
+            const std::size_t label_count = two_pass_label(wide_view,
+                                                           wide_view,
+                                                           std::back_inserter(components),
+                                                           connectivity,
+                                                           W(0),
+                                                           features,
+                                                           engine);
+            copy_wide_labels(view, labels, label_count);
+
             std::move(components.begin(),
                       components.end(),
                       out);
 
-            return labels.label_count();
+            return label_count;
+        }
+
+        template<typename RandomAccessIterator, typename OutputIterator, typename Features>
+        std::size_t wide_two_pass_label(array_view<RandomAccessIterator>& view,
+                                        OutputIterator out,
+                                        unsigned char connectivity,
+                                        const Features& features,
+                                        label_engine engine) {
+            using W = typename wider_label<iterator_value_type<RandomAccessIterator>>::type;
+
+            return wide_two_pass_label(view,
+                                       out,
+                                       connectivity,
+                                       features,
+                                       engine,
+                                       std::integral_constant<bool, !std::is_void<W>::value>());
         }
     } // detail
 } // cvx
@@ -0,0 +1,213 @@
+#ifndef CVX_FEATURES_HPP
+#define CVX_FEATURES_HPP
+
+#include "cvx/connected_component.hpp"
+#include "cvx/export.hpp"
+#include "cvx/feature_flag.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+namespace cvx {
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Gives the static feature policies access to the internals of
+        /// connected components
+        //////////////////////////////////////////////////////////////////////
+        struct component_access {
+            static std::size_t& area(connected_component& component) {
+                return component._area;
+            }
+
+            static point2f& centroid(connected_component& component) {
+                return component._centroid;
+            }
+
+            static rectangle2i& bounding_box(connected_component& component) {
+                return component._bounding_box;
+            }
+        };
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return The sum of the x-coordinates of the run [x_begin, x_end[,
+        ///         length * (x_begin + x_end - 1) / 2, without visiting
+        ///         each element
+        //////////////////////////////////////////////////////////////////////
+        inline double run_coordinate_sum(std::size_t x_begin, std::size_t x_end) {
+            return 0.5 * static_cast<double>(x_end - x_begin) * static_cast<double>(x_begin + x_end - 1);
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// True if T is one of Ts
+        //////////////////////////////////////////////////////////////////////
+        template<typename T, typename... Ts>
+        struct contains_feature : std::false_type {};
+
+        template<typename T, typename U, typename... Ts>
+        struct contains_feature<T, U, Ts...>
+            : std::integral_constant<bool, std::is_same<T, U>::value || contains_feature<T, Ts...>::value> {};
+
+        //////////////////////////////////////////////////////////////////////
+        /// Applies a list of feature policies in order
+        //////////////////////////////////////////////////////////////////////
+        template<typename... Features>
+        struct feature_list;
+
+        template<>
+        struct feature_list<> {
+            static void initialise(connected_component&) {}
+            static void update(std::size_t, std::size_t, connected_component&) {}
+            static void finalise(connected_component&) {}
+        };
+
+        template<typename Feature, typename... Features>
+        struct feature_list<Feature, Features...> {
+            static void initialise(connected_component& component) {
+                Feature::initialise(component);
+                feature_list<Features...>::initialise(component);
+            }
+
+            static void update(std::size_t x, std::size_t y, connected_component& component) {
+                Feature::update(x, y, component);
+                feature_list<Features...>::update(x, y, component);
+            }
+
+            static void finalise(connected_component& component) {
+                Feature::finalise(component);
+                feature_list<Features...>::finalise(component);
+            }
+        };
+    } // detail
+
+    //////////////////////////////////////////////////////////////////////
+    /// Static feature policy that counts the area of each component
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT area final {
+        static void initialise(connected_component&) {}
+
+        static void update(std::size_t, std::size_t, connected_component& component) {
+            ++detail::component_access::area(component);
+        }
+
+        static void finalise(connected_component&) {}
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Static feature policy that computes the centroid of each
+    /// component. Requires the area, which features<> adds if missing
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT centroid final {
+        static void initialise(connected_component& component) {
+            detail::component_access::centroid(component).zero();
+        }
+
+        static void update(std::size_t x, std::size_t y, connected_component& component) {
+            point2f& c = detail::component_access::centroid(component);
+            c.x += x;
+            c.y += y;
+        }
+
+        static void finalise(connected_component& component) {
+            const float area = static_cast<float>(detail::component_access::area(component));
+            point2f& c = detail::component_access::centroid(component);
+            c.x /= area;
+            c.y /= area;
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Static feature policy that computes the bounding box of each
+    /// component
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT bounding_box final {
+        static void initialise(connected_component&) {}
+
+        static void update(std::size_t x, std::size_t y, connected_component& component) {
+            rectangle2i& bb = detail::component_access::bounding_box(component);
+            bb.x = std::min(bb.x, static_cast<int>(x));
+            bb.y = std::min(bb.y, static_cast<int>(y));
+            bb.width = std::max(bb.width, static_cast<int>(x));
+            bb.height = std::max(bb.height, static_cast<int>(y));
+        }
+
+        static void finalise(connected_component& component) {
+            rectangle2i& bb = detail::component_access::bounding_box(component);
+            bb.width = bb.width - bb.x + 1;
+            bb.height = bb.height - bb.y + 1;
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// A compile-time set of feature policies, e.g.
+    /// features<area, centroid, bounding_box>. All policies are applied
+    /// through static calls, so the per-element update is fully inlined
+    /// into the relabelling loop
+    ///
+    /// \param Features Feature policies to extract
+    //////////////////////////////////////////////////////////////////////
+    template<typename... Features>
+    struct CVX_EXPORT features final {
+        // The centroid is normalised by the area, so count it as well
+        using list = typename std::conditional<detail::contains_feature<centroid, Features...>::value &&
+                                                   !detail::contains_feature<area, Features...>::value,
+                                               detail::feature_list<area, Features...>,
+                                               detail::feature_list<Features...>>::type;
+
+        void initialise(connected_component& component) const {
+            list::initialise(component);
+        }
+
+        void update(std::size_t x, std::size_t y, connected_component& component) const {
+            list::update(x, y, component);
+        }
+
+        void update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) const {
+            for (std::size_t x = x_begin; x < x_end; ++x) {
+                list::update(x, y, component);
+            }
+        }
+
+        void finalise(connected_component& component) const {
+            list::finalise(component);
+        }
+    };
+
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// \return True if the flags can be extracted by one of the
+        ///         precompiled static feature sets
+        //////////////////////////////////////////////////////////////////////
+        inline bool has_static_features(const feature_flag& flags) {
+            return !any_flags(flags & ~(feature_flag::area | feature_flag::centroid | feature_flag::bounding_box));
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Call a visitor with the precompiled static feature set that
+        /// matches the flags. Only valid if has_static_features(flags)
+        ///
+        /// \param flags   Bitflag of the component features to extract
+        /// \param visitor Function object with a call operator templated on
+        ///                the feature set
+        /// \return The result of the visitor
+        //////////////////////////////////////////////////////////////////////
+        template<typename Visitor>
+        std::size_t visit_static_features(const feature_flag& flags, Visitor& visitor) {
+            const unsigned int index = (any_flags(flags & feature_flag::area) ? 1 : 0) |
+                                       (any_flags(flags & feature_flag::centroid) ? 2 : 0) |
+                                       (any_flags(flags & feature_flag::bounding_box) ? 4 : 0);
+
+            switch (index) {
+                case 1:  return visitor(features<area>());
+                case 2:  return visitor(features<centroid>());
+                case 3:  return visitor(features<area, centroid>());
+                case 4:  return visitor(features<bounding_box>());
+                case 5:  return visitor(features<area, bounding_box>());
+                case 6:  return visitor(features<centroid, bounding_box>());
+                case 7:  return visitor(features<area, centroid, bounding_box>());
+                default: return visitor(features<>());
+            }
+        }
+    } // detail
+} // cvx
+
+#endif // CVX_FEATURES_HPP
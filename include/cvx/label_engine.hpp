@@ -0,0 +1,16 @@
+#ifndef CVX_LABEL_ENGINE_HPP
+#define CVX_LABEL_ENGINE_HPP
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Selects the scan strategy used in the first pass of the two-pass
+    /// labelling algorithm. All engines produce identical label images
+    //////////////////////////////////////////////////////////////////////
+    enum class label_engine : unsigned int {
+        pixel = 0, /// Scans one pixel at a time (default)
+        block = 1, /// Scans 2x2 blocks at a time (8-connectivity only, 4-connectivity falls back to 'pixel')
+        run   = 2  /// Scans horizontal runs of foreground elements, fastest on images with long runs
+    };
+} // cvx
+
+#endif // CVX_LABEL_ENGINE_HPP
@@ -0,0 +1,91 @@
+#ifndef CVX_LABEL_STATS_HPP
+#define CVX_LABEL_STATS_HPP
+
+#include "cvx/export.hpp"
+#include <cstdlib>
+
+//////////////////////////////////////////////////////////////////////
+/// Two-pass labelling can record per-phase timings and counters into a
+/// label_stats attached to a labeler. Collection is only compiled in if
+/// CVX_COLLECT_STATS is defined (see the CMake option of the same name),
+/// otherwise CVX_STATS expands to nothing and no counters are kept.
+/// The macro only removes the work, every type keeps the same layout,
+/// so code built with it can be linked with a library built without it
+//////////////////////////////////////////////////////////////////////
+#ifdef CVX_COLLECT_STATS
+    #include <chrono>
+
+    #define CVX_STATS(...) __VA_ARGS__
+#else
+    #define CVX_STATS(...)
+#endif
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Statistics of a single two-pass labelling
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT label_stats {
+        double scan_ms;                 /// Time spent in the first scan
+        double flatten_ms;              /// Time spent flattening label equivalences
+        double relabel_ms;              /// Time spent relabelling and extracting features
+        double finalise_ms;             /// Time spent finalising extracted features
+        std::size_t provisional_labels; /// Number of labels created by the scan
+        std::size_t merges;             /// Number of union_find::merge calls
+        std::size_t compression_steps;  /// Number of links redirected by path compression
+        std::size_t peak_scratch_bytes; /// Scratch memory held at the end of the labelling
+        std::size_t components;         /// Number of connected components found
+
+        label_stats() {
+            reset();
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        /// Set all timings and counters to zero
+        //////////////////////////////////////////////////////////////////////
+        void reset() {
+            scan_ms            = 0.0;
+            flatten_ms         = 0.0;
+            relabel_ms         = 0.0;
+            finalise_ms        = 0.0;
+            provisional_labels = 0;
+            merges             = 0;
+            compression_steps  = 0;
+            peak_scratch_bytes = 0;
+            components         = 0;
+        }
+    };
+
+#ifdef CVX_COLLECT_STATS
+    namespace detail {
+        //////////////////////////////////////////////////////////////////////
+        /// Adds the time since the previous lap to a phase of a label_stats,
+        /// or does nothing if there is no label_stats to record into
+        //////////////////////////////////////////////////////////////////////
+        class stats_timer final {
+            public:
+                using clock = std::chrono::steady_clock;
+
+                explicit stats_timer(label_stats* stats)
+                    : stats(stats),
+                      start(clock::now()) {
+                }
+
+                void lap(double label_stats::* phase) {
+                    const clock::time_point now = clock::now();
+
+                    if (stats) {
+                        stats->*phase += std::chrono::duration<double, std::milli>(now - start).count();
+                    }
+
+                    start = now;
+                }
+
+            private:
+                label_stats* stats;
+                clock::time_point start;
+        };
+    } // detail
+#endif
+} // cvx
+
+#endif // CVX_LABEL_STATS_HPP
@@ -0,0 +1,237 @@
+#ifndef CVX_LABELER_HPP
+#define CVX_LABELER_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/bit_plane.hpp"
+#include "cvx/component_table.hpp"
+#include "cvx/export.hpp"
+#include "cvx/feature_flag.hpp"
+#include "cvx/label_engine.hpp"
+#include "cvx/label_stats.hpp"
+#include "cvx/detail/ccl.hpp"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Labels a sequence of images, e.g. video frames, with the same
+    /// settings. All scratch memory (label equivalences, relabelling
+    /// tables, components and contour marks) is kept between calls, so
+    /// once it has grown to the largest image and component count seen,
+    /// labelling with area, centroid and bounding box features performs
+    /// no heap allocations
+    ///
+    /// The overflow fallback to a wider label type and contour features
+    /// still allocate
+    ///
+    /// \param Label Type of the labels written to the label image
+    //////////////////////////////////////////////////////////////////////
+    template<typename Label = int>
+    class CVX_EXPORT labeler final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create a labeler
+            ///
+            /// \param connectivity Neighbourhood connectivity (4 or 8)
+            /// \param flags        Bitflag of the component features to
+            ///                     extract
+            /// \param engine       Scan strategy of the two-pass algorithm
+            //////////////////////////////////////////////////////////////////////
+            explicit labeler(unsigned char connectivity,
+                             const feature_flag& flags = feature_flag::none,
+                             label_engine engine = label_engine::pixel)
+                : connectivity(connectivity),
+                  flags(flags),
+                  engine(engine),
+                  extractors(detail::has_static_features(flags) ? feature_flag::none : flags) {
+                if (connectivity != 4 && connectivity != 8) {
+                    throw exception("Connectivity must be 4 or 8");
+                }
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label the connected components of a view in place
+            ///
+            /// \param view       The view of some image data
+            /// \param foreground Value of foreground elements
+            /// \param background Value of background elements
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename RandomAccessIterator>
+            std::size_t label(array_view<RandomAccessIterator>& view,
+                              iterator_value_type<RandomAccessIterator> foreground,
+                              iterator_value_type<RandomAccessIterator> background) {
+                static_assert(std::is_same<iterator_value_type<RandomAccessIterator>, Label>::value,
+                              "In-place labelling requires the label type as element type");
+
+                detail::validate_arguments(view, view, connectivity, foreground, background);
+
+                if (any_flags(flags & feature_flag::all_contours)) {
+                    scratch.components.clear();
+
+                    return detail::contour_label(view,
+                                                 std::back_inserter(scratch.components),
+                                                 connectivity,
+                                                 background,
+                                                 flags,
+                                                 visited);
+                }
+
+                return label_two_pass(view, view, background);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label the connected components of a constant view into a
+            /// separate label image
+            ///
+            /// \param input      The view of some image data
+            /// \param output     The view of the label image
+            /// \param foreground Value of foreground elements
+            /// \param background Value of background elements
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename InputIterator, typename LabelIterator>
+            std::size_t label(const array_view<InputIterator>& input,
+                              array_view<LabelIterator>& output,
+                              iterator_value_type<InputIterator> foreground,
+                              iterator_value_type<InputIterator> background) {
+                static_assert(std::is_same<iterator_value_type<LabelIterator>, Label>::value,
+                              "Label image must have the label type as element type");
+
+                detail::validate_arguments(input, output, connectivity, foreground, background);
+
+                if (any_flags(flags & feature_flag::all_contours)) {
+                    scratch.components.clear();
+
+                    return detail::contour_label(input,
+                                                 output,
+                                                 std::back_inserter(scratch.components),
+                                                 connectivity,
+                                                 background,
+                                                 flags,
+                                                 visited);
+                }
+
+                return label_two_pass(input, output, background);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label the connected components of a view in place and extract
+            /// their area, centroid and bounding box into a component table.
+            /// The feature flags of the labeler are not used
+            ///
+            /// \param view       The view of some image data
+            /// \param foreground Value of foreground elements
+            /// \param background Value of background elements
+            /// \param table      Receives the features of all components
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename RandomAccessIterator>
+            std::size_t label(array_view<RandomAccessIterator>& view,
+                              iterator_value_type<RandomAccessIterator> foreground,
+                              iterator_value_type<RandomAccessIterator> background,
+                              component_table& table) {
+                static_assert(std::is_same<iterator_value_type<RandomAccessIterator>, Label>::value,
+                              "In-place labelling requires the label type as element type");
+
+                detail::validate_arguments(view, view, connectivity, foreground, background);
+                scratch.components.clear();
+
+                return detail::two_pass_label_table(view, view, connectivity, background, engine, scratch, table);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label the connected components of a constant view into a
+            /// separate label image and extract their area, centroid and
+            /// bounding box into a component table. The feature flags of the
+            /// labeler are not used
+            ///
+            /// \param input      The view of some image data
+            /// \param output     The view of the label image
+            /// \param foreground Value of foreground elements
+            /// \param background Value of background elements
+            /// \param table      Receives the features of all components
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            template<typename InputIterator, typename LabelIterator>
+            std::size_t label(const array_view<InputIterator>& input,
+                              array_view<LabelIterator>& output,
+                              iterator_value_type<InputIterator> foreground,
+                              iterator_value_type<InputIterator> background,
+                              component_table& table) {
+                static_assert(std::is_same<iterator_value_type<LabelIterator>, Label>::value,
+                              "Label image must have the label type as element type");
+
+                detail::validate_arguments(input, output, connectivity, foreground, background);
+                scratch.components.clear();
+
+                return detail::two_pass_label_table(input, output, connectivity, background, engine, scratch, table);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Attach statistics that every following two-pass labelling
+            /// overwrites with its phase timings and counters. They are only
+            /// recorded if cvx is built with CVX_COLLECT_STATS, and never for
+            /// contour labelling
+            ///
+            /// \param stats The statistics to record into, or nullptr to stop
+            ///              recording
+            //////////////////////////////////////////////////////////////////////
+            void set_stats(label_stats* stats) noexcept {
+                scratch.stats = stats;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The components found by the last call to label(). Empty
+            ///         if no features are extracted
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<connected_component>& components() const noexcept {
+                return scratch.components;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Swap the components found by the last call to label() with the
+            /// contents of a vector, to keep them without copying. The
+            /// labeler clears the vector it receives and reuses its storage
+            /// for the next call
+            ///
+            /// \param components Vector to receive the components
+            //////////////////////////////////////////////////////////////////////
+            void swap_components(std::vector<connected_component>& components) noexcept {
+                scratch.components.swap(components);
+            }
+
+        private:
+            template<typename InputIterator, typename LabelIterator>
+            std::size_t label_two_pass(const array_view<InputIterator>& input,
+                                       array_view<LabelIterator>& output,
+                                       iterator_value_type<InputIterator> background) {
+                if (!any_flags(flags)) {
+                    scratch.components.clear();
+
+                    return detail::two_pass_label(input, output, connectivity, background, engine, scratch);
+                }
+
+                return detail::two_pass_label_components(input,
+                                                         output,
+                                                         connectivity,
+                                                         background,
+                                                         flags,
+                                                         extractors,
+                                                         engine,
+                                                         scratch);
+            }
+
+        private:
+            unsigned char connectivity;
+            feature_flag flags;
+            label_engine engine;
+            detail::extractor_set extractors;
+            detail::two_pass_scratch<Label> scratch;
+            bit_plane visited;
+    };
+} // cvx
+
+#endif // CVX_LABELER_HPP
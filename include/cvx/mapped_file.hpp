@@ -0,0 +1,147 @@
+#ifndef CVX_MAPPED_FILE_HPP
+#define CVX_MAPPED_FILE_HPP
+
+#include "cvx/export.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// An open file whose contents can be memory-mapped in windows with
+    /// mapped_region. Only available on POSIX systems, elsewhere opening
+    /// a file throws
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT mapped_file final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Open an existing file
+            ///
+            /// \param path     Path of the file
+            /// \param writable True to allow writable mappings of the file
+            //////////////////////////////////////////////////////////////////////
+            explicit mapped_file(const std::string& path, bool writable = false);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Create a file of a given size, or truncate an existing one to
+            /// it, and open it for writing. The contents read as zeros
+            ///
+            /// \param path Path of the file
+            /// \param size Size of the file in bytes
+            /// \return The open file
+            //////////////////////////////////////////////////////////////////////
+            static mapped_file create(const std::string& path, std::size_t size);
+
+            mapped_file(mapped_file&& other) noexcept;
+            mapped_file& operator=(mapped_file&& other) noexcept;
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Close the file. Regions mapped from it stay valid
+            //////////////////////////////////////////////////////////////////////
+            ~mapped_file();
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The size of the file in bytes
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the file can be mapped for writing
+            //////////////////////////////////////////////////////////////////////
+            bool writable() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The native file descriptor
+            //////////////////////////////////////////////////////////////////////
+            int handle() const noexcept;
+
+        private:
+            mapped_file();
+
+        private:
+            int _fd;
+            std::size_t _size;
+            bool _writable;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// Access pattern hints for a mapped region
+    //////////////////////////////////////////////////////////////////////
+    enum class access_hint : unsigned int {
+        normal     = 0, /// No particular pattern
+        sequential = 1, /// Read ahead aggressively, drop pages once read
+        random     = 2  /// Do not read ahead
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// A memory mapping of a byte range of a mapped_file. The range does
+    /// not need to start on a page boundary, the mapping is widened to the
+    /// enclosing pages and data() points to the first requested byte.
+    /// Writes to a writable region go straight to the file
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT mapped_region final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create an empty region
+            //////////////////////////////////////////////////////////////////////
+            mapped_region() noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Map a byte range of a file
+            ///
+            /// \param file     The file to map
+            /// \param offset   Offset of the first byte to map
+            /// \param length   Number of bytes to map
+            /// \param writable True to map the range for writing, which
+            ///                 requires a writable file
+            /// \param hint     Expected access pattern
+            //////////////////////////////////////////////////////////////////////
+            mapped_region(const mapped_file& file,
+                          std::size_t offset,
+                          std::size_t length,
+                          bool writable = false,
+                          access_hint hint = access_hint::normal);
+
+            mapped_region(mapped_region&& other) noexcept;
+            mapped_region& operator=(mapped_region&& other) noexcept;
+            mapped_region(const mapped_region&) = delete;
+            mapped_region& operator=(const mapped_region&) = delete;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Unmap the region
+            //////////////////////////////////////////////////////////////////////
+            ~mapped_region();
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Pointer to the first mapped byte
+            //////////////////////////////////////////////////////////////////////
+            std::uint8_t* data() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of mapped bytes
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Give the kernel a hint about the access pattern of the region
+            ///
+            /// \param hint Expected access pattern
+            //////////////////////////////////////////////////////////////////////
+            void advise(access_hint hint) const;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Unmap the region early
+            //////////////////////////////////////////////////////////////////////
+            void reset() noexcept;
+
+        private:
+            void* _base;
+            std::size_t _base_length;
+            std::uint8_t* _data;
+            std::size_t _size;
+    };
+} // cvx
+
+#endif // CVX_MAPPED_FILE_HPP
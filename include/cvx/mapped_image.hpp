@@ -0,0 +1,122 @@
+#ifndef CVX_MAPPED_IMAGE_HPP
+#define CVX_MAPPED_IMAGE_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/bit_view.hpp"
+#include "cvx/export.hpp"
+#include "cvx/mapped_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// File formats that mapped_image can map
+    //////////////////////////////////////////////////////////////////////
+    enum class image_format : unsigned int {
+        raw = 0, /// Headerless 8-bit pixels
+        pbm = 1, /// Binary PBM (P4), one bit per pixel, set bits are black
+        pgm = 2  /// Binary PGM (P5), one or two big-endian bytes per pixel
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// An image file whose pixels are memory-mapped read-only and used in
+    /// place, so labelling starts without reading or copying the file.
+    /// The mapping is hinted as sequential by default, which suits the
+    /// raster order of the labelling scans
+    ///
+    /// The views returned by the image refer to the mapping and are only
+    /// valid while the image exists
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT mapped_image final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Map a binary PBM (P4) or PGM (P5) file
+            ///
+            /// \param path Path of the file
+            /// \param hint Expected access pattern of the pixels
+            //////////////////////////////////////////////////////////////////////
+            explicit mapped_image(const std::string& path, access_hint hint = access_hint::sequential);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Map a headerless file of 8-bit pixels
+            ///
+            /// \param path   Path of the file
+            /// \param width  Width of the image
+            /// \param height Height of the image
+            /// \param stride Number of bytes between rows, zero for
+            ///               unpadded rows
+            /// \param offset Offset of the first pixel in bytes
+            /// \param hint   Expected access pattern of the pixels
+            //////////////////////////////////////////////////////////////////////
+            mapped_image(const std::string& path,
+                         std::size_t width,
+                         std::size_t height,
+                         std::size_t stride = 0,
+                         std::size_t offset = 0,
+                         access_hint hint = access_hint::sequential);
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The format of the file
+            //////////////////////////////////////////////////////////////////////
+            image_format format() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The width of the image in pixels
+            //////////////////////////////////////////////////////////////////////
+            std::size_t width() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The height of the image in pixels
+            //////////////////////////////////////////////////////////////////////
+            std::size_t height() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of bytes between rows
+            //////////////////////////////////////////////////////////////////////
+            std::size_t stride() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The largest pixel value, one for PBM and 255 for raw
+            ///         files
+            //////////////////////////////////////////////////////////////////////
+            std::size_t maxval() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return Pointer to the first byte of the pixels
+            //////////////////////////////////////////////////////////////////////
+            const std::uint8_t* data() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \param y Index of a row
+            /// \return Pointer to the first byte of the row
+            //////////////////////////////////////////////////////////////////////
+            const std::uint8_t* row(std::size_t y) const;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return A view of the pixels of an 8-bit PGM or raw image,
+            ///         which is strided if the rows are padded
+            //////////////////////////////////////////////////////////////////////
+            array_view<const std::uint8_t*> view() const;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return A view of the pixels of a PBM image, which is true for
+            ///         black pixels
+            //////////////////////////////////////////////////////////////////////
+            bit_view bits() const;
+
+        private:
+            void map(std::size_t offset, access_hint hint);
+
+        private:
+            mapped_file _file;
+            mapped_region _region;
+            image_format _format;
+            std::size_t _width;
+            std::size_t _height;
+            std::size_t _stride;
+            std::size_t _maxval;
+    };
+} // cvx
+
+#endif // CVX_MAPPED_IMAGE_HPP
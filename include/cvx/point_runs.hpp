@@ -0,0 +1,241 @@
+#ifndef CVX_POINT_RUNS_HPP
+#define CVX_POINT_RUNS_HPP
+
+#include "cvx/export.hpp"
+#include "cvx/point2.hpp"
+#include "cvx/rectangle2.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// A horizontal run of elements [x_begin, x_end) on row y
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT point_run {
+        int y;
+        int x_begin;
+        int x_end;
+
+        //////////////////////////////////////////////////////////////////////
+        /// \return The number of elements in the run
+        //////////////////////////////////////////////////////////////////////
+        std::size_t length() const noexcept {
+            return static_cast<std::size_t>(x_end - x_begin);
+        }
+
+        bool operator==(const point_run& other) const noexcept {
+            return y == other.y && x_begin == other.x_begin && x_end == other.x_end;
+        }
+
+        bool operator!=(const point_run& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// The point set of a connected component stored as horizontal runs
+    /// in raster order. A run costs as much as one and a half points, so
+    /// solid components take a fraction of the memory of a vector of
+    /// points, membership is a binary search over the runs and the points
+    /// are only expanded while iterating
+    ///
+    /// Points must be added in raster order, which is the order in which
+    /// the relabelling pass visits the elements of a component
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT point_runs final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Forward iterator that expands the runs into their points
+            //////////////////////////////////////////////////////////////////////
+            class const_iterator {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = point2i;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const point2i*;
+                    using reference = const point2i&;
+
+                    const_iterator() = default;
+
+                    const_iterator(std::vector<point_run>::const_iterator run,
+                                   std::vector<point_run>::const_iterator last)
+                        : _run(run),
+                          _last(last) {
+                        if (_run != _last) {
+                            _point.x = _run->x_begin;
+                            _point.y = _run->y;
+                        }
+                    }
+
+                    reference operator*() const noexcept {
+                        return _point;
+                    }
+
+                    pointer operator->() const noexcept {
+                        return &_point;
+                    }
+
+                    const_iterator& operator++() {
+                        if (++_point.x == _run->x_end && ++_run != _last) {
+                            _point.x = _run->x_begin;
+                            _point.y = _run->y;
+                        }
+
+                        return *this;
+                    }
+
+                    const_iterator operator++(int) {
+                        const_iterator temp(*this);
+                        ++*this;
+                        return temp;
+                    }
+
+                    bool operator==(const const_iterator& other) const noexcept {
+                        return _run == other._run && (_run == _last || _point.x == other._point.x);
+                    }
+
+                    bool operator!=(const const_iterator& other) const noexcept {
+                        return !(*this == other);
+                    }
+
+                private:
+                    std::vector<point_run>::const_iterator _run;
+                    std::vector<point_run>::const_iterator _last;
+                    point2i _point;
+            };
+
+            //////////////////////////////////////////////////////////////////////
+            /// Add a point after all points added so far, extending the last
+            /// run if the point directly follows it
+            ///
+            /// \param x x-coordinate of the point
+            /// \param y y-coordinate of the point
+            //////////////////////////////////////////////////////////////////////
+            void add(int x, int y) {
+                if (!_runs.empty() && _runs.back().y == y && _runs.back().x_end == x) {
+                    ++_runs.back().x_end;
+                } else {
+                    _runs.push_back(point_run{ y, x, x + 1 });
+                }
+
+                ++_size;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Add the points [x_begin, x_end) of row y after all points added
+            /// so far
+            ///
+            /// \param y       Row of the run
+            /// \param x_begin First x-coordinate of the run
+            /// \param x_end   One past the last x-coordinate of the run
+            //////////////////////////////////////////////////////////////////////
+            void add_run(int y, int x_begin, int x_end) {
+                if (x_begin >= x_end) {
+                    return;
+                }
+
+                if (!_runs.empty() && _runs.back().y == y && _runs.back().x_end == x_begin) {
+                    _runs.back().x_end = x_end;
+                } else {
+                    _runs.push_back(point_run{ y, x_begin, x_end });
+                }
+
+                _size += static_cast<std::size_t>(x_end - x_begin);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Query if a point is in the set in O(log n) of the number of
+            /// runs
+            ///
+            /// \param p The query point
+            /// \return True if the point is in the set
+            //////////////////////////////////////////////////////////////////////
+            bool contains(const point2i& p) const {
+                // The first run that starts after p, the one before it is the
+                // only run that can contain p
+                auto it = std::upper_bound(_runs.cbegin(), _runs.cend(), p, [](const point2i& q, const point_run& run) {
+                    return q.y < run.y || (q.y == run.y && q.x < run.x_begin);
+                });
+
+                if (it == _runs.cbegin()) {
+                    return false;
+                }
+
+                --it;
+                return it->y == p.y && p.x < it->x_end;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The smallest rectangle that contains all points
+            //////////////////////////////////////////////////////////////////////
+            rectangle2i bounding_box() const {
+                if (_runs.empty()) {
+                    return rectangle2i(0, 0, 0, 0);
+                }
+
+                int min_x = std::numeric_limits<int>::max();
+                int max_x = std::numeric_limits<int>::min();
+
+                for (const auto& run : _runs) {
+                    min_x = std::min(min_x, run.x_begin);
+                    max_x = std::max(max_x, run.x_end);
+                }
+
+                return rectangle2i(min_x, _runs.front().y, max_x - min_x, _runs.back().y - _runs.front().y + 1);
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// Remove all points
+            //////////////////////////////////////////////////////////////////////
+            void clear() noexcept {
+                _runs.clear();
+                _size = 0;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of points in the set
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept {
+                return _size;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if the set has no points
+            //////////////////////////////////////////////////////////////////////
+            bool empty() const noexcept {
+                return _size == 0;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The runs of the set in raster order
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<point_run>& runs() const noexcept {
+                return _runs;
+            }
+
+            const_iterator begin() const {
+                return const_iterator(_runs.cbegin(), _runs.cend());
+            }
+
+            const_iterator end() const {
+                return const_iterator(_runs.cend(), _runs.cend());
+            }
+
+            const_iterator cbegin() const {
+                return begin();
+            }
+
+            const_iterator cend() const {
+                return end();
+            }
+
+        private:
+            std::vector<point_run> _runs;
+            std::size_t _size = 0;
+    };
+} // cvx
+
+#endif // CVX_POINT_RUNS_HPP
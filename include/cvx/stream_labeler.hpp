@@ -0,0 +1,142 @@
+#ifndef CVX_STREAM_LABELER_HPP
+#define CVX_STREAM_LABELER_HPP
+
+#include "cvx/connected_component.hpp"
+#include "cvx/exception.hpp"
+#include "cvx/export.hpp"
+#include "cvx/utils.hpp"
+#include "cvx/detail/run_label.hpp"
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Labels an image that arrives one row at a time, e.g. from a
+    /// line-scan camera, without ever holding the whole image. Only the
+    /// foreground runs of the previous row and the components that still
+    /// touch it are kept, so memory is proportional to the width and the
+    /// number of live components instead of the image size
+    ///
+    /// A component is finished as soon as a row does not touch it, since
+    /// no later row can. Its area, centroid and bounding box are then
+    /// available through components() until the next row is pushed.
+    /// Components are labelled 1, 2, ... in the order they finish, and
+    /// components that finish on the same row are ordered by the left-most
+    /// run of their last row
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT stream_labeler final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create a streaming labeler
+            ///
+            /// \param width        Number of elements in each row
+            /// \param connectivity Neighbourhood connectivity (4 or 8)
+            //////////////////////////////////////////////////////////////////////
+            stream_labeler(std::size_t width, unsigned char connectivity);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label the next row
+            ///
+            /// \param first      Iterator to the beginning of the row
+            /// \param last       Iterator to the end of the row
+            /// \param background Value of background elements
+            /// \return The number of components finished by this row
+            //////////////////////////////////////////////////////////////////////
+            template<typename InputIterator>
+            std::size_t push_row(InputIterator first,
+                                 InputIterator last,
+                                 iterator_value_type<InputIterator> background) {
+                if (static_cast<std::size_t>(std::distance(first, last)) != _width) {
+                    throw exception("Row must have the width of the labeler");
+                }
+
+                _current.clear();
+                detail::extract_runs(first, _width, background, _current);
+
+                return advance();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// End the image, finishing all components that touch the last
+            /// row. The next row pushed starts a new image, whose labels
+            /// continue from this one until reset() is called
+            ///
+            /// \return The number of components finished
+            //////////////////////////////////////////////////////////////////////
+            std::size_t finish();
+
+            //////////////////////////////////////////////////////////////////////
+            /// Forget the current image and all its components but keep the
+            /// allocated storage
+            //////////////////////////////////////////////////////////////////////
+            void reset();
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The components finished by the last call to push_row()
+            ///         or finish()
+            //////////////////////////////////////////////////////////////////////
+            const std::vector<connected_component>& components() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of components finished since the labeler
+            ///         was created or reset
+            //////////////////////////////////////////////////////////////////////
+            std::size_t label_count() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of components that may still grow
+            //////////////////////////////////////////////////////////////////////
+            std::size_t live_count() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of rows pushed in the current image
+            //////////////////////////////////////////////////////////////////////
+            std::size_t rows() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The width of the rows
+            //////////////////////////////////////////////////////////////////////
+            std::size_t width() const noexcept;
+
+        private:
+            // The accumulated features of a live component. Records of
+            // components that were merged into another point to its record
+            // until the end of the row, and are then reused
+            struct record {
+                std::size_t parent;
+                std::size_t area;
+                double sum_x;
+                double sum_y;
+                std::size_t min_x;
+                std::size_t min_y;
+                std::size_t max_x;
+                std::size_t max_y;
+                std::size_t row;
+            };
+
+            using run = detail::label_run<std::size_t>;
+
+            std::size_t advance();
+            std::size_t new_record();
+            std::size_t root(std::size_t id);
+            std::size_t merge(std::size_t a, std::size_t b);
+            void add_run(std::size_t id, const run& r);
+            void emit(std::size_t id);
+
+        private:
+            std::size_t _width;
+            unsigned char _connectivity;
+            std::size_t _row;
+            std::size_t _label_count;
+            std::size_t _live_count;
+            std::vector<run> _above;
+            std::vector<run> _current;
+            std::vector<record> _records;
+            std::vector<std::size_t> _free;
+            std::vector<std::size_t> _merged;
+            std::vector<connected_component> _finished;
+    };
+} // cvx
+
+#endif // CVX_STREAM_LABELER_HPP
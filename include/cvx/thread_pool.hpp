@@ -0,0 +1,88 @@
+#ifndef CVX_THREAD_POOL_HPP
+#define CVX_THREAD_POOL_HPP
+
+#include "cvx/export.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// A fixed-size pool of worker threads used to run labelling work in
+    /// parallel. Threads are created once and reused across calls
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT thread_pool final {
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create a pool with a given number of threads
+            ///
+            /// \param thread_count Number of threads. Zero uses the number of
+            ///                     hardware threads
+            //////////////////////////////////////////////////////////////////////
+            explicit thread_pool(std::size_t thread_count = 0);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Join all threads
+            //////////////////////////////////////////////////////////////////////
+            ~thread_pool();
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of threads that run tasks, including the
+            ///         thread calling parallel_for
+            //////////////////////////////////////////////////////////////////////
+            std::size_t size() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Call task(i) for every i in [0, count[ and wait until all calls
+            /// have finished. The calling thread also runs tasks. If a task
+            /// throws, the first exception is rethrown here
+            ///
+            /// \param count Number of tasks
+            /// \param task  Function to call for each task index
+            //////////////////////////////////////////////////////////////////////
+            void parallel_for(std::size_t count,
+                              const std::function<void(std::size_t)>& task);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Call task(i, worker) for every i in [0, count[ and wait until
+            /// all calls have finished. Idle threads take the next unclaimed
+            /// task, so uneven tasks are balanced across threads. worker is
+            /// the index in [0, size()[ of the thread running the task, which
+            /// is unique among the threads of one call, e.g. to give each
+            /// thread its own scratch memory
+            ///
+            /// \param count Number of tasks
+            /// \param task  Function to call for each task and worker index
+            //////////////////////////////////////////////////////////////////////
+            void parallel_for_worker(std::size_t count,
+                                     const std::function<void(std::size_t, std::size_t)>& task);
+
+        private:
+            void work(std::size_t worker);
+            void run_tasks(std::size_t worker);
+
+        private:
+            std::vector<std::thread> _threads;
+            std::mutex _submit_mutex;
+            std::mutex _mutex;
+            std::condition_variable _start;
+            std::condition_variable _done;
+            const std::function<void(std::size_t, std::size_t)>* _task;
+            std::size_t _count;
+            std::atomic<std::size_t> _next;
+            std::size_t _finished;
+            std::size_t _generation;
+            std::exception_ptr _error;
+            bool _stop;
+    };
+} // cvx
+
+#endif // CVX_THREAD_POOL_HPP
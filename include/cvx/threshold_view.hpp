@@ -0,0 +1,172 @@
+#ifndef CVX_THRESHOLD_VIEW_HPP
+#define CVX_THRESHOLD_VIEW_HPP
+
+#include "cvx/array_view.hpp"
+#include "cvx/export.hpp"
+#include <cstddef>
+#include <iterator>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Predicate that is true for values in the closed range [lo, hi]
+    //////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct CVX_EXPORT in_range final {
+        T lo;
+        T hi;
+
+        bool operator()(const T& value) const {
+            return !(value < lo) && !(hi < value);
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// A read-only random access iterator that classifies the elements
+    /// of some image data with a unary predicate when dereferenced. It
+    /// yields true for foreground elements, i.e. where the predicate
+    /// holds
+    ///
+    /// Labelling through a threshold view classifies each element inside
+    /// the scan, instead of first thresholding into a separate binary
+    /// image and then labelling that
+    //////////////////////////////////////////////////////////////////////
+    template<typename Iterator, typename Predicate>
+    class CVX_EXPORT threshold_iterator final {
+        public:
+            using value_type        = bool;
+            using reference         = bool;
+            using pointer           = void;
+            using difference_type   = typename std::iterator_traits<Iterator>::difference_type;
+            using iterator_category = std::random_access_iterator_tag;
+
+        public:
+            //////////////////////////////////////////////////////////////////////
+            /// Create an iterator to an element of some image data
+            ///
+            /// \param it   Iterator to the element
+            /// \param pred Unary predicate that identifies foreground
+            ///             elements
+            //////////////////////////////////////////////////////////////////////
+            threshold_iterator(Iterator it, Predicate pred)
+                : _it(it),
+                  _pred(pred) {
+            }
+
+            reference operator*() const {
+                return static_cast<bool>(_pred(*_it));
+            }
+
+            reference operator[](difference_type n) const {
+                return static_cast<bool>(_pred(_it[n]));
+            }
+
+            threshold_iterator& operator++() { ++_it; return *this; }
+            threshold_iterator& operator--() { --_it; return *this; }
+            threshold_iterator operator++(int) { threshold_iterator it(*this); ++_it; return it; }
+            threshold_iterator operator--(int) { threshold_iterator it(*this); --_it; return it; }
+            threshold_iterator& operator+=(difference_type n) { _it += n; return *this; }
+            threshold_iterator& operator-=(difference_type n) { _it -= n; return *this; }
+
+            threshold_iterator operator+(difference_type n) const {
+                return threshold_iterator(_it + n, _pred);
+            }
+
+            threshold_iterator operator-(difference_type n) const {
+                return threshold_iterator(_it - n, _pred);
+            }
+
+            difference_type operator-(const threshold_iterator& other) const { return _it - other._it; }
+
+            bool operator==(const threshold_iterator& other) const { return _it == other._it; }
+            bool operator!=(const threshold_iterator& other) const { return _it != other._it; }
+            bool operator<(const threshold_iterator& other) const  { return _it < other._it; }
+            bool operator>(const threshold_iterator& other) const  { return _it > other._it; }
+            bool operator<=(const threshold_iterator& other) const { return _it <= other._it; }
+            bool operator>=(const threshold_iterator& other) const { return _it >= other._it; }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The underlying iterator
+            //////////////////////////////////////////////////////////////////////
+            Iterator base() const {
+                return _it;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The predicate that identifies foreground elements
+            //////////////////////////////////////////////////////////////////////
+            const Predicate& predicate() const noexcept {
+                return _pred;
+            }
+
+        private:
+            Iterator _it;
+            Predicate _pred;
+    };
+
+    template<typename Iterator, typename Predicate>
+    threshold_iterator<Iterator, Predicate>
+    operator+(typename threshold_iterator<Iterator, Predicate>::difference_type n,
+              const threshold_iterator<Iterator, Predicate>& it) {
+        return it + n;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// A binary view of some image data whose foreground elements are
+    /// those where a predicate holds
+    //////////////////////////////////////////////////////////////////////
+    template<typename Iterator, typename Predicate>
+    using threshold_view = array_view<threshold_iterator<Iterator, Predicate>>;
+
+    //////////////////////////////////////////////////////////////////////
+    /// Create a binary view of some image data that classifies elements
+    /// with a predicate as they are read
+    ///
+    /// \param first  Iterator to the beginning of the image data
+    /// \param last   Iterator to the end of the image data
+    /// \param width  Width of the image data
+    /// \param height Height of the image data
+    /// \param pred   Unary predicate that identifies foreground elements
+    /// \return A view with true for foreground and false for background
+    ///         elements, whose iterators can be passed to all labelling
+    ///         functions that write labels to a separate range
+    //////////////////////////////////////////////////////////////////////
+    template<typename Iterator, typename Predicate>
+    threshold_view<Iterator, Predicate> make_threshold_view(Iterator first,
+                                                            Iterator last,
+                                                            std::size_t width,
+                                                            std::size_t height,
+                                                            Predicate pred) {
+        return threshold_view<Iterator, Predicate>(threshold_iterator<Iterator, Predicate>(first, pred),
+                                                   threshold_iterator<Iterator, Predicate>(last, pred),
+                                                   width,
+                                                   height);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// Create a binary view of some image data whose foreground elements
+    /// are those with values in [lo, hi]
+    ///
+    /// \param first  Iterator to the beginning of the image data
+    /// \param last   Iterator to the end of the image data
+    /// \param width  Width of the image data
+    /// \param height Height of the image data
+    /// \param lo     Smallest foreground value
+    /// \param hi     Largest foreground value
+    /// \return A view with true for foreground and false for background
+    ///         elements
+    //////////////////////////////////////////////////////////////////////
+    template<typename Iterator>
+    threshold_view<Iterator, in_range<typename std::iterator_traits<Iterator>::value_type>>
+    make_threshold_view(Iterator first,
+                        Iterator last,
+                        std::size_t width,
+                        std::size_t height,
+                        typename std::iterator_traits<Iterator>::value_type lo,
+                        typename std::iterator_traits<Iterator>::value_type hi) {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+
+        return make_threshold_view(first, last, width, height, in_range<T>{ lo, hi });
+    }
+} // cvx
+
+#endif // CVX_THRESHOLD_VIEW_HPP
@@ -0,0 +1,109 @@
+#ifndef CVX_TILED_LABELER_HPP
+#define CVX_TILED_LABELER_HPP
+
+#include "cvx/export.hpp"
+#include "cvx/label_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Labels binary images stored in files that are too large to label
+    /// in memory, e.g. gigapixel slide or satellite masks. The input is
+    /// memory-mapped one tile of full rows at a time, each tile is labelled
+    /// on its own, and the labels are written to a memory-mapped output
+    /// file of native-endian 32-bit labels in row-major order
+    ///
+    /// Only labels on the top and bottom rows of a tile can continue into
+    /// another tile. These border labels are resolved through one global
+    /// union-find, and a second pass over the tiles rewrites all labels to
+    /// their final values. Components that touch a tile border get the
+    /// labels 1 to K in the order of the first tile they appear in, and
+    /// all other components follow tile by tile in raster order
+    ///
+    /// Peak memory is the tile budget, plus a few words per tile, plus the
+    /// global union-find with one element per distinct label on the top or
+    /// bottom row of a tile. A component can reconnect through any later
+    /// tile, so these elements are kept until the end. They are at most
+    /// 2 * width per tile, so in the worst case the union-find grows with
+    /// tile_count() * width rather than with the tile budget
+    //////////////////////////////////////////////////////////////////////
+    class CVX_EXPORT tiled_labeler final {
+        public:
+            using label_type = std::uint32_t;
+
+            //////////////////////////////////////////////////////////////////////
+            /// Create a tiled labeler
+            ///
+            /// \param connectivity Neighbourhood connectivity (4 or 8)
+            /// \param tile_budget  Approximate number of bytes to spend on
+            ///                     the mapped input, mapped output and
+            ///                     labelling scratch memory of a tile
+            /// \param engine       Scan strategy used for each tile
+            //////////////////////////////////////////////////////////////////////
+            explicit tiled_labeler(unsigned char connectivity,
+                                   std::size_t tile_budget = std::size_t(64) << 20,
+                                   label_engine engine = label_engine::run);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label a binary PBM (P4) or 8-bit PGM (P5) file. Black PBM
+            /// pixels and non-zero PGM pixels are foreground
+            ///
+            /// \param input_path  Path of the image file
+            /// \param output_path Path of the label file to create
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            std::size_t label_file(const std::string& input_path, const std::string& output_path);
+
+            //////////////////////////////////////////////////////////////////////
+            /// Label a headerless file of 8-bit pixels in row-major order
+            ///
+            /// \param input_path  Path of the image file
+            /// \param output_path Path of the label file to create
+            /// \param width       Width of the image
+            /// \param height      Height of the image
+            /// \param background  Value of background pixels
+            /// \return The number of connected components found
+            //////////////////////////////////////////////////////////////////////
+            std::size_t label_raw_file(const std::string& input_path,
+                                       const std::string& output_path,
+                                       std::size_t width,
+                                       std::size_t height,
+                                       std::uint8_t background = 0);
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of rows per tile of the last labelling
+            //////////////////////////////////////////////////////////////////////
+            std::size_t tile_rows() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of tiles of the last labelling
+            //////////////////////////////////////////////////////////////////////
+            std::size_t tile_count() const noexcept;
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of border labels in the global union-find
+            ///         of the last labelling
+            //////////////////////////////////////////////////////////////////////
+            std::size_t border_labels() const noexcept;
+
+        private:
+            template<typename Input>
+            std::size_t label_tiles(const Input& input,
+                                    const std::string& output_path,
+                                    std::size_t width,
+                                    std::size_t height,
+                                    std::size_t stride);
+
+        private:
+            unsigned char _connectivity;
+            std::size_t _tile_budget;
+            label_engine _engine;
+            std::size_t _tile_rows;
+            std::size_t _tile_count;
+            std::size_t _border_labels;
+    };
+} // cvx
+
+#endif // CVX_TILED_LABELER_HPP
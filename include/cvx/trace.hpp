@@ -0,0 +1,64 @@
+#ifndef CVX_TRACE_HPP
+#define CVX_TRACE_HPP
+
+#include "cvx/export.hpp"
+#include "cvx/point2.hpp"
+#include <cstdlib>
+
+//////////////////////////////////////////////////////////////////////
+/// Contour tracing can report every traced contour to a user hook for
+/// profiling. The hook is only compiled in if CVX_TRACE_CONTOURS is
+/// defined (see the CMake option of the same name), otherwise
+/// CVX_TRACE_CONTOUR expands to nothing and its arguments are never
+/// evaluated
+//////////////////////////////////////////////////////////////////////
+#ifdef CVX_TRACE_CONTOURS
+    #include <atomic>
+#endif
+
+namespace cvx {
+    //////////////////////////////////////////////////////////////////////
+    /// Summary of a single traced contour
+    //////////////////////////////////////////////////////////////////////
+    struct CVX_EXPORT contour_trace {
+        point2i start;     /// First point of the contour
+        std::size_t steps; /// Number of Moore neighbours examined
+        std::size_t length;/// Number of points on the contour
+        bool external;     /// True for an outer contour
+    };
+
+    using contour_trace_hook = void (*)(const contour_trace&);
+
+#ifdef CVX_TRACE_CONTOURS
+    namespace detail {
+        inline std::atomic<contour_trace_hook>& contour_hook() {
+            static std::atomic<contour_trace_hook> hook(nullptr);
+            return hook;
+        }
+
+        inline void report_contour(const contour_trace& trace) {
+            contour_trace_hook hook = contour_hook().load(std::memory_order_acquire);
+
+            if (hook) {
+                hook(trace);
+            }
+        }
+    } // detail
+
+    //////////////////////////////////////////////////////////////////////
+    /// Set the function that receives every traced contour. The hook may
+    /// be called from multiple threads at once
+    ///
+    /// \param hook The new hook, or nullptr to disable reporting
+    //////////////////////////////////////////////////////////////////////
+    inline void set_contour_trace_hook(contour_trace_hook hook) {
+        detail::contour_hook().store(hook, std::memory_order_release);
+    }
+
+    #define CVX_TRACE_CONTOUR(...) ::cvx::detail::report_contour(::cvx::contour_trace{ __VA_ARGS__ })
+#else
+    #define CVX_TRACE_CONTOUR(...) static_cast<void>(0)
+#endif
+} // cvx
+
+#endif // CVX_TRACE_HPP
@@ -2,13 +2,16 @@
 #define CVX_UNION_FIND_HPP
 
 #include "cvx/export.hpp"
+#include "cvx/label_stats.hpp"
+#include <limits>
 #include <type_traits>
 #include <vector>
 
 namespace cvx {
     //////////////////////////////////////////////////////////////////////
     /// An implementation of a disjoint set data structure for integral
-    /// types
+    /// types. Labels are stored as T, so the equivalence table is as
+    /// compact as the label image it belongs to
     //////////////////////////////////////////////////////////////////////
     template<typename T>
     class CVX_EXPORT union_find final {
@@ -20,7 +23,8 @@ namespace cvx {
             /// Construct an empty unionfind
             //////////////////////////////////////////////////////////////////////
             union_find()
-                : _label_count(0) {
+                : _label_count(0),
+                  _overflow(false) {
                 // Labels start at 1
                 labels.push_back(0);
             }
@@ -29,13 +33,26 @@ namespace cvx {
             /// Construct an empty unionfind with an initial capacity
             //////////////////////////////////////////////////////////////////////
             union_find(std::size_t capacity)
-                : _label_count(0) {
+                : _label_count(0),
+                  _overflow(false) {
                 labels.reserve(capacity);
                 
                 // Labels start at 1
                 labels.push_back(0);
             }
 
+            //////////////////////////////////////////////////////////////////////
+            /// Remove all labels but keep the allocated storage, so the union
+            /// find can be reused without reallocating
+            //////////////////////////////////////////////////////////////////////
+            void reset() {
+                labels.resize(1);
+                _label_count = 0;
+                _overflow = false;
+                CVX_STATS(_merges = 0;)
+                CVX_STATS(_compression_steps = 0;)
+            }
+
             //////////////////////////////////////////////////////////////////////
             /// Returns the root currently pointed to by a label
             ///
@@ -59,6 +76,26 @@ namespace cvx {
                 labels.push_back(value);
             }
 
+            //////////////////////////////////////////////////////////////////////
+            /// Create a new label that is its own root. If T cannot represent
+            /// the new label, the union find is marked as overflowed and the
+            /// existing label 1 is returned instead. This keeps the scan in
+            /// bounds and foreground elements non-zero, so the caller can
+            /// finish scanning and fall back to a wider label type afterwards
+            ///
+            /// \return The new label
+            //////////////////////////////////////////////////////////////////////
+            T new_label() {
+                if (labels.size() > static_cast<std::size_t>(std::numeric_limits<T>::max())) {
+                    _overflow = true;
+                    return T(1);
+                }
+
+                labels.push_back(static_cast<T>(labels.size()));
+
+                return labels.back();
+            }
+
             //////////////////////////////////////////////////////////////////////
             /// Compresses the path from a label to its root, and set its root
             ///
@@ -70,6 +107,7 @@ namespace cvx {
                     T temp = labels[label];
                     labels[label] = root;
                     label = temp;
+                    CVX_STATS(++_compression_steps;)
                 }
 
                 labels[label] = root;
@@ -83,6 +121,7 @@ namespace cvx {
             /// \return The common root of label1 and label2
             //////////////////////////////////////////////////////////////////////
             T merge(T label1, T label2) {
+                CVX_STATS(++_merges;)
                 T root1 = root(label1);
 
                 if (label1 != label2) {
@@ -104,13 +143,15 @@ namespace cvx {
             /// consecutive labels and compute the number of unique labels
             //////////////////////////////////////////////////////////////////////
             void flatten() {
-                T k = T(1);
+                // Counted wider than T, there may be as many roots as T's
+                // largest value
+                std::size_t k = 1;
 
                 for (std::size_t i = 1; i < labels.size(); ++i) {
-                    if (labels[i] < i) {
+                    if (static_cast<std::size_t>(labels[i]) < i) {
                         labels[i] = labels[labels[i]];
                     } else {
-                        labels[i] = k++;
+                        labels[i] = static_cast<T>(k++);
                     }
                 }
 
@@ -125,6 +166,16 @@ namespace cvx {
                 return labels[i];
             }
 
+            //////////////////////////////////////////////////////////////////////
+            /// \return The equivalence table, in which entry i is get(i). Entry
+            ///         0 is always 0, so after flatten() the table maps a
+            ///         whole label image, background included, to its final
+            ///         labels
+            //////////////////////////////////////////////////////////////////////
+            const T* data() const noexcept {
+                return labels.data();
+            }
+
             //////////////////////////////////////////////////////////////////////
             /// \return True if the union_find is empty
             //////////////////////////////////////////////////////////////////////
@@ -146,9 +197,44 @@ namespace cvx {
                 return _label_count;
             }
 
+            //////////////////////////////////////////////////////////////////////
+            /// \return True if more labels were requested than T can represent
+            //////////////////////////////////////////////////////////////////////
+            bool overflow() const noexcept {
+                return _overflow;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of labels the union find can hold without
+            ///         reallocating
+            //////////////////////////////////////////////////////////////////////
+            std::size_t capacity() const noexcept {
+                return labels.capacity();
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of merge() calls since the last reset(),
+            ///         always zero unless built with CVX_COLLECT_STATS
+            //////////////////////////////////////////////////////////////////////
+            std::size_t merge_count() const noexcept {
+                return _merges;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            /// \return The number of links redirected by path compression
+            ///         since the last reset(), always zero unless built with
+            ///         CVX_COLLECT_STATS
+            //////////////////////////////////////////////////////////////////////
+            std::size_t compression_steps() const noexcept {
+                return _compression_steps;
+            }
+
         private:
             std::size_t _label_count;
-            std::vector<int> labels;
+            bool _overflow;
+            std::size_t _merges = 0;
+            std::size_t _compression_steps = 0;
+            std::vector<T> labels;
     };
 } // cvx
 
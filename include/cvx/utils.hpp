@@ -10,7 +10,7 @@
 #include "cvx/detail/centroid_extractor.hpp"
 #include "cvx/detail/point_extractor.hpp"
 #include "cvx/detail/bounding_box_extractor.hpp"
-#include <memory>
+#include <iterator>
 #include <vector>
 
 #ifdef CVX_HAS_OPENCV
@@ -18,107 +18,96 @@
 #endif
 
 namespace cvx {
-    //////////////////////////////////////////////////////////////////////
-    /// Threshold arbitrary image data
-    ///
-    /// \param RandomAccessIterator Any random access iterator
-    /// \param OutputIterator       An output iterator with arithmetic type
-    /// \param UnaryPredicate       Predicate that identifies background
-    ///                             elements
-    /// \param first                Iterator to the start of the image
-    ///                             data
-    /// \param last                 Iterator to the end of the image data
-    /// \param width                Width of the image data
-    /// \param height               Height of the image data
-    /// \param out                  Destination iterator (may be the same
-    ///                             as the input iterator)
-    /// \param pred                 Unary predicate that identifies
-    ///                             background elements
-    //////////////////////////////////////////////////////////////////////
-    //template<typename RandomAccessIterator,
-    //         typename OutputIterator,
-    //         typename UnaryPredicate>
-    //CVX_EXPORT void threshold(RandomAccessIterator first,
-    //                          RandomAccessIterator last,
-    //                          std::size_t width,
-    //                          std::size_t height,
-    //                          OutputIterator out,
-    //                          typename std::iterator_traits<RandomAccessIterator>::value_type background,
-    //                          UnaryPredicate pred) {
-    //   // Output iterator must have the connected component as value type
-    //   static_assert(std::is_arithmetic<typename std::iterator_traits<OutputIterator>::value_type>::value,
-    //                "Output iterator must have arithmetic type as value type");
-
-    //   array_view<RandomAccessIterator> view(first,
-    //                                         last,
-    //                                         width,
-    //                                         height,
-
-    //   for (auto it = view.begin(); it != view.cend(); ++it, ++out) {
-    //       if (pred(*it)) {
-    //           *out = background;
-    //       }
-    //   }
-    //}
-    
+    template<typename Iterator>
+    using iterator_value_type = typename std::iterator_traits<Iterator>::value_type;
+
     namespace detail {
         template<typename Iterator>
         using diff_type = typename std::iterator_traits<Iterator>::difference_type;
 
-        template<typename OutputIterator>
-        void make_extractors_from_flags(const feature_flag& flags,
-                                        OutputIterator out) {
-            if (!flags) {
-                return;
-            }
-
-            // Static local vector of reuseable extractors to avoid consecutive reallocations
-            static std::vector<std::shared_ptr<extractor>> extractors;
+        //////////////////////////////////////////////////////////////////////
+        /// Resolve the dependencies between feature flags to the set of
+        /// extractors that need to run, e.g. the centroid needs the area
+        ///
+        /// \param flags Bitflag of the component features to extract
+        /// \return Bitflag of the extractors to run
+        //////////////////////////////////////////////////////////////////////
+        inline feature_flag extractor_flags(const feature_flag& flags) {
+            feature_flag result = flags & (feature_flag::area |
+                                           feature_flag::centroid |
+                                           feature_flag::points |
+                                           feature_flag::bounding_box);
 
-            if (extractors.empty()) {
-                extractors.emplace_back(std::make_shared<area_extractor>());
-                extractors.emplace_back(std::make_shared<centroid_extractor>());
-                extractors.emplace_back(std::make_shared<point_extractor>());
-                extractors.emplace_back(std::make_shared<bounding_box_extractor>());
+            if (any_flags(flags & feature_flag::centroid)) {
+                result = result | feature_flag::area;
             }
 
-            // This is a very unelegant method of selecting the extractors
-            // from the feature_flag, but we cannot iterate enums or enum
-            // classes in C++
-           if (any_flags(flags & feature_flag::area)) {
-                *out++ = extractors[0];
+            if (any_flags(flags & feature_flag::extent)) {
+                // The extent is computed as the ratio between the bounding box
+                // and the size of the connected component
+                result = result | feature_flag::points | feature_flag::bounding_box;
             }
 
-            if (any_flags(flags & feature_flag::centroid)) {
-                *out++ = extractors[1];
+            return result;
+        }
 
-                if (!any_flags(flags & feature_flag::area)) {
-                    *out++ = extractors[0];
+        //////////////////////////////////////////////////////////////////////
+        /// A runtime set of feature extractors with the same interface as
+        /// the static feature sets. Only used for features without a static
+        /// policy
+        ///
+        /// Each set owns its extractors, so sets used by different threads
+        /// share no state. Create one per call or keep one per workspace
+        //////////////////////////////////////////////////////////////////////
+        class extractor_set final {
+            public:
+                explicit extractor_set(const feature_flag& flags)
+                    : flags(extractor_flags(flags)) {
                 }
-            }
 
-            if (any_flags(flags & feature_flag::points)) {
-                *out++ = extractors[2];
-            }
+                void initialise(connected_component& component) const {
+                    if (has(feature_flag::area))         { area.initialise(component); }
+                    if (has(feature_flag::centroid))     { centroid.initialise(component); }
+                    if (has(feature_flag::points))       { points.initialise(component); }
+                    if (has(feature_flag::bounding_box)) { bounding_box.initialise(component); }
+                }
 
-            if (any_flags(flags & feature_flag::bounding_box)) {
-                *out++ = extractors[3];
-            }
+                void update(std::size_t x, std::size_t y, connected_component& component) const {
+                    if (has(feature_flag::area))         { area.update(x, y, component); }
+                    if (has(feature_flag::centroid))     { centroid.update(x, y, component); }
+                    if (has(feature_flag::points))       { points.update(x, y, component); }
+                    if (has(feature_flag::bounding_box)) { bounding_box.update(x, y, component); }
+                }
 
-            if (any_flags(flags & feature_flag::extent)) {
-                // The extent is computed as the ratio between the bounding box
-                // and the size of the connected component
+                void update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) const {
+                    if (has(feature_flag::area))         { area.update_run(x_begin, x_end, y, component); }
+                    if (has(feature_flag::centroid))     { centroid.update_run(x_begin, x_end, y, component); }
+                    if (has(feature_flag::points))       { points.update_run(x_begin, x_end, y, component); }
+                    if (has(feature_flag::bounding_box)) { bounding_box.update_run(x_begin, x_end, y, component); }
+                }
 
-                // Do not add the any extractors twice
-                if (!any_flags(flags & feature_flag::points)) {
-                    *out++ = extractors[2];
+                void finalise(connected_component& component) const {
+                    if (has(feature_flag::area))         { area.finalise(component); }
+                    if (has(feature_flag::centroid))     { centroid.finalise(component); }
+                    if (has(feature_flag::points))       { points.finalise(component); }
+                    if (has(feature_flag::bounding_box)) { bounding_box.finalise(component); }
                 }
 
-                if (!any_flags(flags & feature_flag::bounding_box)) {
-                    *out++ = extractors[3];
+            private:
+                bool has(const feature_flag& flag) const {
+                    return any_flags(flags & flag);
                 }
-            }
-        }
+
+            private:
+                feature_flag flags;
+
+                // The extractors keep no state of their own, they are only
+                // mutable because their interface is not const
+                mutable area_extractor area;
+                mutable centroid_extractor centroid;
+                mutable point_extractor points;
+                mutable bounding_box_extractor bounding_box;
+        };
     } // detail
 } // cvx
 
@@ -38,6 +38,10 @@ namespace cvx {
     }
 
     bool connected_component::contains(const point2i& p) const {
+        if (!_runs.empty()) {
+            return _runs.contains(p);
+        }
+
         if (points().empty()) {
             throw exception("No point data");
         }
@@ -62,7 +66,10 @@ namespace cvx {
     }
 
     const std::vector<point2i>& connected_component::points() const {
-        if (_points.empty()) {
+        if (_points.empty() && !_runs.empty()) {
+            _points.reserve(_runs.size());
+            _points.assign(_runs.cbegin(), _runs.cend());
+        } else if (_points.empty()) {
             rectangle2i bb = bounding_box();
 
             if (bb.width == -1 && bb.height == -1) {
@@ -81,6 +88,10 @@ namespace cvx {
         return _points;
     }
 
+    const point_runs& connected_component::runs() const noexcept {
+        return _runs;
+    }
+
     const std::vector<point2i>& connected_component::contour() const {
         if (_contour.empty()) {
             //const auto& temp = points();
@@ -118,6 +129,17 @@ namespace cvx {
 
     rectangle2i connected_component::bounding_box() const {
         if (_bounding_box.area() == 0) {
+            if (!_runs.empty()) {
+                const rectangle2i box = _runs.bounding_box();
+
+                _bounding_box.x = box.x;
+                _bounding_box.y = box.y;
+                _bounding_box.width = box.width;
+                _bounding_box.height = box.height;
+
+                return _bounding_box;
+            }
+
             if (_points.empty()) {
                 throw exception("Need at least point set to infer bounding box");
             }
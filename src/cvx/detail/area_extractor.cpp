@@ -11,6 +11,10 @@ namespace cvx {
             ++component._area;
         }
 
+        void area_extractor::update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) {
+            component._area += x_end - x_begin;
+        }
+
         void area_extractor::finalise(connected_component& component) {
         }
     }
@@ -8,6 +8,12 @@ namespace cvx {
         void extractor::update(std::size_t x, std::size_t y, connected_component& component) {
         }
 
+        void extractor::update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) {
+            for (std::size_t x = x_begin; x < x_end; ++x) {
+                update(x, y, component);
+            }
+        }
+
         void extractor::finalise(connected_component& component) {
         }
     } // detail
@@ -0,0 +1,100 @@
+#include "cvx/detail/pnm.hpp"
+#include "cvx/exception.hpp"
+#include <cctype>
+#include <fstream>
+
+namespace cvx {
+    namespace detail {
+        namespace {
+            // Skip whitespace and comments, which run to the end of the line
+            void skip_separators(std::istream& in) {
+                int c = in.peek();
+
+                while (c != EOF && (std::isspace(c) || c == '#')) {
+                    if (c == '#') {
+                        while (c != EOF && c != '\n' && c != '\r') {
+                            in.get();
+                            c = in.peek();
+                        }
+                    } else {
+                        in.get();
+                        c = in.peek();
+                    }
+                }
+            }
+
+            std::size_t read_number(std::istream& in, const std::string& path) {
+                skip_separators(in);
+
+                if (!std::isdigit(in.peek())) {
+                    throw exception("Malformed header in '" + path + "'");
+                }
+
+                std::size_t value = 0;
+
+                while (std::isdigit(in.peek())) {
+                    const std::size_t digit = static_cast<std::size_t>(in.get() - '0');
+
+                    if (multiply_overflows(value, 10) || add_overflows(value * 10, digit)) {
+                        throw exception("Header value is too large in '" + path + "'");
+                    }
+
+                    value = value * 10 + digit;
+                }
+
+                return value;
+            }
+        } // anonymous
+
+        pnm_header read_pnm_header(const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+
+            if (!in) {
+                throw exception("Unable to open '" + path + "'");
+            }
+
+            char magic[2] = { 0, 0 };
+            in.read(magic, 2);
+
+            if (magic[0] != 'P' || (magic[1] != '4' && magic[1] != '5')) {
+                throw exception("'" + path + "' is not a binary PBM or PGM file");
+            }
+
+            pnm_header header;
+            header.format = (magic[1] == '4' ? pnm_format::pbm : pnm_format::pgm);
+            header.width = read_number(in, path);
+            header.height = read_number(in, path);
+            header.maxval = (header.format == pnm_format::pgm ? read_number(in, path) : 1);
+
+            // Exactly one whitespace character separates the header from
+            // the pixels
+            if (!std::isspace(in.get())) {
+                throw exception("Malformed header in '" + path + "'");
+            }
+
+            if (header.width == 0 || header.height == 0) {
+                throw exception("'" + path + "' has no pixels");
+            }
+
+            if (header.maxval == 0 || header.maxval > 65535) {
+                throw exception("'" + path + "' has an invalid maximum value");
+            }
+
+            header.offset = static_cast<std::size_t>(in.tellg());
+
+            if (header.format == pnm_format::pbm) {
+                header.stride = header.width / 8 + (header.width % 8 ? 1 : 0);
+            } else {
+                const std::size_t bytes = (header.maxval < 256 ? 1 : 2);
+
+                if (multiply_overflows(header.width, bytes)) {
+                    throw exception("'" + path + "' is too large");
+                }
+
+                header.stride = header.width * bytes;
+            }
+
+            return header;
+        }
+    } // detail
+} // cvx
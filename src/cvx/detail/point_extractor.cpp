@@ -6,13 +6,15 @@ namespace cvx {
         void point_extractor::initialise(connected_component& component) {}
 
         void point_extractor::update(std::size_t x, std::size_t y, connected_component& component) {
-            //component.points().emplace_back(x, y);
-            component._points.emplace_back(x, y);
+            component._runs.add(static_cast<int>(x), static_cast<int>(y));
+        }
+
+        void point_extractor::update_run(std::size_t x_begin, std::size_t x_end, std::size_t y, connected_component& component) {
+            component._runs.add_run(static_cast<int>(y), static_cast<int>(x_begin), static_cast<int>(x_end));
         }
 
         void point_extractor::finalise(connected_component& component) {
-            //component.area() = component.points().size();
-            component._area = component._points.size();
+            component._area = component._runs.size();
         }
     }
 }
@@ -0,0 +1,293 @@
+#include "cvx/detail/simd.hpp"
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define CVX_SIMD_X86
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define CVX_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace cvx {
+    namespace detail {
+        namespace {
+            template<typename U>
+            using find_function = std::size_t (*)(const U*, std::size_t, std::size_t, U);
+
+            template<typename U>
+            U load(const U* p) {
+                // Rows may alias signed integers of the same size
+                U value;
+                std::memcpy(&value, p, sizeof(U));
+                return value;
+            }
+
+            template<typename U, bool Equal>
+            std::size_t find_scalar(const U* row, std::size_t first, std::size_t last, U value) {
+                while (first < last && (load(row + first) == value) != Equal) {
+                    ++first;
+                }
+
+                return first;
+            }
+
+#if defined(CVX_SIMD_X86) || defined(CVX_SIMD_NEON)
+            inline unsigned int count_trailing_zeros(std::uint64_t mask) {
+                return static_cast<unsigned int>(__builtin_ctzll(mask));
+            }
+#endif
+
+#ifdef CVX_SIMD_X86
+            __attribute__((target("sse4.1"))) inline __m128i broadcast128(std::uint8_t v)  { return _mm_set1_epi8(static_cast<char>(v)); }
+            __attribute__((target("sse4.1"))) inline __m128i broadcast128(std::uint16_t v) { return _mm_set1_epi16(static_cast<short>(v)); }
+            __attribute__((target("sse4.1"))) inline __m128i broadcast128(std::uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+            __attribute__((target("sse4.1"))) inline __m128i broadcast128(std::uint64_t v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+
+            __attribute__((target("sse4.1"))) inline __m128i compare128(__m128i a, __m128i b, std::uint8_t)  { return _mm_cmpeq_epi8(a, b); }
+            __attribute__((target("sse4.1"))) inline __m128i compare128(__m128i a, __m128i b, std::uint16_t) { return _mm_cmpeq_epi16(a, b); }
+            __attribute__((target("sse4.1"))) inline __m128i compare128(__m128i a, __m128i b, std::uint32_t) { return _mm_cmpeq_epi32(a, b); }
+            __attribute__((target("sse4.1"))) inline __m128i compare128(__m128i a, __m128i b, std::uint64_t) { return _mm_cmpeq_epi64(a, b); }
+
+            template<typename U, bool Equal>
+            __attribute__((target("sse4.1")))
+            std::size_t find_sse41(const U* row, std::size_t first, std::size_t last, U value) {
+                const std::size_t lanes = 16 / sizeof(U);
+                const __m128i values = broadcast128(value);
+
+                for (; first + lanes <= last; first += lanes) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + first));
+                    unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(compare128(block, values, U())));
+
+                    if (!Equal) {
+                        mask = ~mask & 0xffffu;
+                    }
+
+                    if (mask) {
+                        return first + count_trailing_zeros(mask) / sizeof(U);
+                    }
+                }
+
+                return find_scalar<U, Equal>(row, first, last, value);
+            }
+
+            __attribute__((target("avx2"))) inline __m256i broadcast256(std::uint8_t v)  { return _mm256_set1_epi8(static_cast<char>(v)); }
+            __attribute__((target("avx2"))) inline __m256i broadcast256(std::uint16_t v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+            __attribute__((target("avx2"))) inline __m256i broadcast256(std::uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+            __attribute__((target("avx2"))) inline __m256i broadcast256(std::uint64_t v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+
+            __attribute__((target("avx2"))) inline __m256i compare256(__m256i a, __m256i b, std::uint8_t)  { return _mm256_cmpeq_epi8(a, b); }
+            __attribute__((target("avx2"))) inline __m256i compare256(__m256i a, __m256i b, std::uint16_t) { return _mm256_cmpeq_epi16(a, b); }
+            __attribute__((target("avx2"))) inline __m256i compare256(__m256i a, __m256i b, std::uint32_t) { return _mm256_cmpeq_epi32(a, b); }
+            __attribute__((target("avx2"))) inline __m256i compare256(__m256i a, __m256i b, std::uint64_t) { return _mm256_cmpeq_epi64(a, b); }
+
+            template<typename U, bool Equal>
+            __attribute__((target("avx2")))
+            std::size_t find_avx2(const U* row, std::size_t first, std::size_t last, U value) {
+                const std::size_t lanes = 32 / sizeof(U);
+                const __m256i values = broadcast256(value);
+
+                for (; first + lanes <= last; first += lanes) {
+                    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + first));
+                    std::uint64_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(compare256(block, values, U())));
+
+                    if (!Equal) {
+                        mask = ~mask & 0xffffffffu;
+                    }
+
+                    if (mask) {
+                        return first + count_trailing_zeros(mask) / sizeof(U);
+                    }
+                }
+
+                return find_scalar<U, Equal>(row, first, last, value);
+            }
+
+            template<typename U, bool Equal>
+            find_function<U> select_kernel() {
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2")) {
+                    return &find_avx2<U, Equal>;
+                } else if (__builtin_cpu_supports("sse4.1")) {
+                    return &find_sse41<U, Equal>;
+                }
+
+                return &find_scalar<U, Equal>;
+            }
+
+            const char* select_kernel_name() {
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2")) {
+                    return "avx2";
+                } else if (__builtin_cpu_supports("sse4.1")) {
+                    return "sse4.1";
+                }
+
+                return "scalar";
+            }
+#elif defined(CVX_SIMD_NEON)
+            inline uint8x16_t compare_neon(const std::uint8_t* p, std::uint8_t v)   { return vceqq_u8(vld1q_u8(p), vdupq_n_u8(v)); }
+            inline uint8x16_t compare_neon(const std::uint16_t* p, std::uint16_t v) { return vreinterpretq_u8_u16(vceqq_u16(vld1q_u16(p), vdupq_n_u16(v))); }
+            inline uint8x16_t compare_neon(const std::uint32_t* p, std::uint32_t v) { return vreinterpretq_u8_u32(vceqq_u32(vld1q_u32(p), vdupq_n_u32(v))); }
+            inline uint8x16_t compare_neon(const std::uint64_t* p, std::uint64_t v) { return vreinterpretq_u8_u64(vceqq_u64(vld1q_u64(p), vdupq_n_u64(v))); }
+
+            template<typename U, bool Equal>
+            std::size_t find_neon(const U* row, std::size_t first, std::size_t last, U value) {
+                const std::size_t lanes = 16 / sizeof(U);
+
+                for (; first + lanes <= last; first += lanes) {
+                    uint8x16_t equal = compare_neon(row + first, value);
+
+                    if (!Equal) {
+                        equal = vmvnq_u8(equal);
+                    }
+
+                    // Narrow each byte of the comparison to four bits
+                    const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+
+                    if (mask) {
+                        return first + count_trailing_zeros(mask) / (4 * sizeof(U));
+                    }
+                }
+
+                return find_scalar<U, Equal>(row, first, last, value);
+            }
+
+            template<typename U, bool Equal>
+            find_function<U> select_kernel() {
+                return &find_neon<U, Equal>;
+            }
+
+            const char* select_kernel_name() {
+                return "neon";
+            }
+#else
+            template<typename U, bool Equal>
+            find_function<U> select_kernel() {
+                return &find_scalar<U, Equal>;
+            }
+
+            const char* select_kernel_name() {
+                return "scalar";
+            }
+#endif
+
+            template<typename U>
+            using lookup_function = void (*)(U*, std::size_t, const U*);
+
+            template<typename U>
+            void lookup_scalar(U* labels, std::size_t count, const U* table) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    labels[i] = table[labels[i]];
+                }
+            }
+
+#ifdef CVX_SIMD_X86
+            __attribute__((target("avx2")))
+            void lookup_avx2(std::uint32_t* labels, std::size_t count, const std::uint32_t* table) {
+                const int* base = reinterpret_cast<const int*>(table);
+                std::size_t i = 0;
+
+                for (; i + 8 <= count; i += 8) {
+                    __m256i* p = reinterpret_cast<__m256i*>(labels + i);
+                    _mm256_storeu_si256(p, _mm256_i32gather_epi32(base, _mm256_loadu_si256(p), 4));
+                }
+
+                lookup_scalar(labels + i, count - i, table);
+            }
+
+            __attribute__((target("avx2")))
+            void lookup_avx2(std::uint64_t* labels, std::size_t count, const std::uint64_t* table) {
+                const long long* base = reinterpret_cast<const long long*>(table);
+                std::size_t i = 0;
+
+                for (; i + 4 <= count; i += 4) {
+                    __m256i* p = reinterpret_cast<__m256i*>(labels + i);
+                    _mm256_storeu_si256(p, _mm256_i64gather_epi64(base, _mm256_loadu_si256(p), 8));
+                }
+
+                lookup_scalar(labels + i, count - i, table);
+            }
+
+            template<typename U>
+            lookup_function<U> select_lookup_kernel() {
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2")) {
+                    return static_cast<lookup_function<U>>(&lookup_avx2);
+                }
+
+                return &lookup_scalar<U>;
+            }
+#else
+            // NEON has no gather, the lookups stay scalar
+            template<typename U>
+            lookup_function<U> select_lookup_kernel() {
+                return &lookup_scalar<U>;
+            }
+#endif
+
+            template<typename U>
+            void lookup(U* labels, std::size_t count, const U* table) {
+                static const lookup_function<U> kernel = select_lookup_kernel<U>();
+
+                kernel(labels, count, table);
+            }
+
+            template<typename U, bool Equal>
+            std::size_t find(const U* row, std::size_t first, std::size_t last, U value) {
+                static const find_function<U> kernel = select_kernel<U, Equal>();
+
+                return kernel(row, first, last, value);
+            }
+        } // anonymous
+
+        std::size_t find_equal(const std::uint8_t* row, std::size_t first, std::size_t last, std::uint8_t value) {
+            return find<std::uint8_t, true>(row, first, last, value);
+        }
+
+        std::size_t find_equal(const std::uint16_t* row, std::size_t first, std::size_t last, std::uint16_t value) {
+            return find<std::uint16_t, true>(row, first, last, value);
+        }
+
+        std::size_t find_equal(const std::uint32_t* row, std::size_t first, std::size_t last, std::uint32_t value) {
+            return find<std::uint32_t, true>(row, first, last, value);
+        }
+
+        std::size_t find_equal(const std::uint64_t* row, std::size_t first, std::size_t last, std::uint64_t value) {
+            return find<std::uint64_t, true>(row, first, last, value);
+        }
+
+        std::size_t find_not_equal(const std::uint8_t* row, std::size_t first, std::size_t last, std::uint8_t value) {
+            return find<std::uint8_t, false>(row, first, last, value);
+        }
+
+        std::size_t find_not_equal(const std::uint16_t* row, std::size_t first, std::size_t last, std::uint16_t value) {
+            return find<std::uint16_t, false>(row, first, last, value);
+        }
+
+        std::size_t find_not_equal(const std::uint32_t* row, std::size_t first, std::size_t last, std::uint32_t value) {
+            return find<std::uint32_t, false>(row, first, last, value);
+        }
+
+        std::size_t find_not_equal(const std::uint64_t* row, std::size_t first, std::size_t last, std::uint64_t value) {
+            return find<std::uint64_t, false>(row, first, last, value);
+        }
+
+        void lookup_labels(std::uint32_t* labels, std::size_t count, const std::uint32_t* table) {
+            lookup<std::uint32_t>(labels, count, table);
+        }
+
+        void lookup_labels(std::uint64_t* labels, std::size_t count, const std::uint64_t* table) {
+            lookup<std::uint64_t>(labels, count, table);
+        }
+
+        const char* simd_kernel_name() {
+            static const char* name = select_kernel_name();
+
+            return name;
+        }
+    } // detail
+} // cvx
@@ -0,0 +1,225 @@
+#include "cvx/mapped_file.hpp"
+#include "cvx/exception.hpp"
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define CVX_HAS_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace cvx {
+    namespace {
+        std::string system_error(const std::string& what, const std::string& path) {
+            return what + " '" + path + "': " + std::strerror(errno);
+        }
+    } // anonymous
+
+#ifdef CVX_HAS_MMAP
+    mapped_file::mapped_file()
+        : _fd(-1),
+          _size(0),
+          _writable(false) {
+    }
+
+    mapped_file::mapped_file(const std::string& path, bool writable)
+        : _fd(-1),
+          _size(0),
+          _writable(writable) {
+        _fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+
+        if (_fd < 0) {
+            throw exception(system_error("Unable to open", path));
+        }
+
+        struct stat info;
+
+        if (::fstat(_fd, &info) != 0) {
+            ::close(_fd);
+            throw exception(system_error("Unable to query", path));
+        }
+
+        _size = static_cast<std::size_t>(info.st_size);
+    }
+
+    mapped_file mapped_file::create(const std::string& path, std::size_t size) {
+        mapped_file file;
+        file._fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        file._writable = true;
+
+        if (file._fd < 0) {
+            throw exception(system_error("Unable to create", path));
+        }
+
+        if (::ftruncate(file._fd, static_cast<off_t>(size)) != 0) {
+            throw exception(system_error("Unable to resize", path));
+        }
+
+        file._size = size;
+
+        return file;
+    }
+
+    mapped_file::~mapped_file() {
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+    }
+#else
+    mapped_file::mapped_file()
+        : _fd(-1),
+          _size(0),
+          _writable(false) {
+    }
+
+    mapped_file::mapped_file(const std::string&, bool)
+        : mapped_file() {
+        throw exception("Memory-mapped files are not supported on this platform");
+    }
+
+    mapped_file mapped_file::create(const std::string&, std::size_t) {
+        throw exception("Memory-mapped files are not supported on this platform");
+    }
+
+    mapped_file::~mapped_file() {
+    }
+#endif
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+        : _fd(other._fd),
+          _size(other._size),
+          _writable(other._writable) {
+        other._fd = -1;
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+        std::swap(_fd, other._fd);
+        std::swap(_size, other._size);
+        std::swap(_writable, other._writable);
+
+        return *this;
+    }
+
+    std::size_t mapped_file::size() const noexcept {
+        return _size;
+    }
+
+    bool mapped_file::writable() const noexcept {
+        return _writable;
+    }
+
+    int mapped_file::handle() const noexcept {
+        return _fd;
+    }
+
+    mapped_region::mapped_region() noexcept
+        : _base(nullptr),
+          _base_length(0),
+          _data(nullptr),
+          _size(0) {
+    }
+
+#ifdef CVX_HAS_MMAP
+    mapped_region::mapped_region(const mapped_file& file,
+                                 std::size_t offset,
+                                 std::size_t length,
+                                 bool writable,
+                                 access_hint hint)
+        : mapped_region() {
+        if (offset > file.size() || length > file.size() - offset) {
+            throw exception("Mapped region exceeds the file");
+        }
+
+        if (writable && !file.writable()) {
+            throw exception("File is not writable");
+        }
+
+        if (length == 0) {
+            return;
+        }
+
+        // Mappings must start on a page boundary
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t base_offset = offset - offset % page;
+
+        _base_length = length + (offset - base_offset);
+        _base = ::mmap(nullptr,
+                       _base_length,
+                       writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                       MAP_SHARED,
+                       file.handle(),
+                       static_cast<off_t>(base_offset));
+
+        if (_base == MAP_FAILED) {
+            _base = nullptr;
+            throw exception(std::string("Unable to map file: ") + std::strerror(errno));
+        }
+
+        _data = static_cast<std::uint8_t*>(_base) + (offset - base_offset);
+        _size = length;
+
+        advise(hint);
+    }
+
+    void mapped_region::advise(access_hint hint) const {
+        if (!_base || hint == access_hint::normal) {
+            return;
+        }
+
+        // Hints are only advisory, so failing to apply one is not an error
+        ::madvise(_base, _base_length, hint == access_hint::sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    }
+
+    void mapped_region::reset() noexcept {
+        if (_base) {
+            ::munmap(_base, _base_length);
+        }
+
+        _base = nullptr;
+        _base_length = 0;
+        _data = nullptr;
+        _size = 0;
+    }
+#else
+    mapped_region::mapped_region(const mapped_file&, std::size_t, std::size_t, bool, access_hint)
+        : mapped_region() {
+        throw exception("Memory-mapped files are not supported on this platform");
+    }
+
+    void mapped_region::advise(access_hint) const {
+    }
+
+    void mapped_region::reset() noexcept {
+    }
+#endif
+
+    mapped_region::mapped_region(mapped_region&& other) noexcept
+        : mapped_region() {
+        *this = std::move(other);
+    }
+
+    mapped_region& mapped_region::operator=(mapped_region&& other) noexcept {
+        std::swap(_base, other._base);
+        std::swap(_base_length, other._base_length);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+
+        return *this;
+    }
+
+    mapped_region::~mapped_region() {
+        reset();
+    }
+
+    std::uint8_t* mapped_region::data() const noexcept {
+        return _data;
+    }
+
+    std::size_t mapped_region::size() const noexcept {
+        return _size;
+    }
+} // cvx
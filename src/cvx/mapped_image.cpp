@@ -0,0 +1,127 @@
+#include "cvx/mapped_image.hpp"
+#include "cvx/exception.hpp"
+#include "cvx/detail/pnm.hpp"
+
+namespace cvx {
+    mapped_image::mapped_image(const std::string& path, access_hint hint)
+        : _file(path) {
+        const detail::pnm_header header = detail::read_pnm_header(path);
+
+        _format = (header.format == detail::pnm_format::pbm ? image_format::pbm : image_format::pgm);
+        _width = header.width;
+        _height = header.height;
+        _stride = header.stride;
+        _maxval = header.maxval;
+
+        map(header.offset, hint);
+    }
+
+    mapped_image::mapped_image(const std::string& path,
+                               std::size_t width,
+                               std::size_t height,
+                               std::size_t stride,
+                               std::size_t offset,
+                               access_hint hint)
+        : _file(path),
+          _format(image_format::raw),
+          _width(width),
+          _height(height),
+          _stride(stride ? stride : width),
+          _maxval(255) {
+        if (width == 0 || height == 0) {
+            throw exception("Image must have pixels");
+        }
+
+        if (_stride < width) {
+            throw exception("Stride is too small for the width");
+        }
+
+        map(offset, hint);
+    }
+
+    void mapped_image::map(std::size_t offset, access_hint hint) {
+        // The last row does not need its padding
+        const std::size_t bytes = (_maxval < 256 ? 1 : 2);
+
+        if (_format != image_format::pbm && detail::multiply_overflows(_width, bytes)) {
+            throw exception("Image is too large");
+        }
+
+        const std::size_t row_bytes = (_format == image_format::pbm ? _width / 8 + (_width % 8 ? 1 : 0) :
+                                       _width * bytes);
+
+        if (detail::multiply_overflows(_stride, _height - 1) ||
+            detail::add_overflows(_stride * (_height - 1), row_bytes)) {
+            throw exception("Image is too large");
+        }
+
+        const std::size_t length = _stride * (_height - 1) + row_bytes;
+
+        if (length == 0) {
+            throw exception("Image has no pixel data");
+        }
+
+        if (offset > _file.size() || length > _file.size() - offset) {
+            throw exception("Image file is truncated");
+        }
+
+        _region = mapped_region(_file, offset, length, false, hint);
+    }
+
+    image_format mapped_image::format() const noexcept {
+        return _format;
+    }
+
+    std::size_t mapped_image::width() const noexcept {
+        return _width;
+    }
+
+    std::size_t mapped_image::height() const noexcept {
+        return _height;
+    }
+
+    std::size_t mapped_image::stride() const noexcept {
+        return _stride;
+    }
+
+    std::size_t mapped_image::maxval() const noexcept {
+        return _maxval;
+    }
+
+    const std::uint8_t* mapped_image::data() const noexcept {
+        return _region.data();
+    }
+
+    const std::uint8_t* mapped_image::row(std::size_t y) const {
+        if (y >= _height) {
+            throw exception("Row out of bounds");
+        }
+
+        return data() + y * _stride;
+    }
+
+    array_view<const std::uint8_t*> mapped_image::view() const {
+        if (_format == image_format::pbm) {
+            throw exception("PBM images are viewed with bits()");
+        }
+
+        if (_maxval > 255) {
+            throw exception("Only 8-bit images can be viewed");
+        }
+
+        // The mapping ends after the last pixel, not after the padding
+        return array_view<const std::uint8_t*>(data(),
+                                               data() + _stride * (_height - 1) + _width,
+                                               _width,
+                                               _height,
+                                               _stride);
+    }
+
+    bit_view mapped_image::bits() const {
+        if (_format != image_format::pbm) {
+            throw exception("Only PBM images can be viewed as bits");
+        }
+
+        return make_bit_view(data(), _width, _height, _stride, bit_order::msb_first);
+    }
+} // cvx
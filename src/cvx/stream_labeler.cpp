@@ -0,0 +1,241 @@
+#include "cvx/stream_labeler.hpp"
+#include "cvx/features.hpp"
+#include <limits>
+#include <utility>
+
+namespace cvx {
+    stream_labeler::stream_labeler(std::size_t width, unsigned char connectivity)
+        : _width(width),
+          _connectivity(connectivity),
+          _row(0),
+          _label_count(0),
+          _live_count(0) {
+        if (connectivity != 4 && connectivity != 8) {
+            throw exception("Connectivity must be 4 or 8");
+        }
+
+        if (width == 0) {
+            throw exception("Width must be positive");
+        }
+
+        // Record ids start at 1 so that zero means unlabelled
+        _records.resize(1);
+    }
+
+    std::size_t stream_labeler::finish() {
+        _finished.clear();
+
+        // No row has this stamp, so every live component is emitted once
+        const std::size_t stamp = _row + 1;
+
+        for (const run& r : _above) {
+            const std::size_t id = root(r.label);
+
+            if (_records[id].row != stamp) {
+                emit(id);
+                _records[id].row = stamp;
+            }
+        }
+
+        _above.clear();
+        _records.resize(1);
+        _free.clear();
+        _merged.clear();
+        _row = 0;
+        _live_count = 0;
+
+        return _finished.size();
+    }
+
+    void stream_labeler::reset() {
+        _above.clear();
+        _current.clear();
+        _records.resize(1);
+        _free.clear();
+        _merged.clear();
+        _finished.clear();
+        _row = 0;
+        _label_count = 0;
+        _live_count = 0;
+    }
+
+    const std::vector<connected_component>& stream_labeler::components() const noexcept {
+        return _finished;
+    }
+
+    std::size_t stream_labeler::label_count() const noexcept {
+        return _label_count;
+    }
+
+    std::size_t stream_labeler::live_count() const noexcept {
+        return _live_count;
+    }
+
+    std::size_t stream_labeler::rows() const noexcept {
+        return _row;
+    }
+
+    std::size_t stream_labeler::width() const noexcept {
+        return _width;
+    }
+
+    std::size_t stream_labeler::advance() {
+        _finished.clear();
+
+        // Runs in adjacent rows touch diagonally under 8-connectivity
+        const std::size_t reach = (_connectivity == 8 ? 1 : 0);
+        const std::size_t stamp = _row + 1;
+        std::size_t i = 0;
+
+        for (run& r : _current) {
+            // Skip runs above that end before this one can touch them
+            while (i < _above.size() && _above[i].end + reach <= r.start) {
+                ++i;
+            }
+
+            std::size_t id = 0;
+            std::size_t k = i;
+
+            for (; k < _above.size() && _above[k].start < r.end + reach; ++k) {
+                id = id ? merge(id, _above[k].label) : root(_above[k].label);
+            }
+
+            if (!id) {
+                id = new_record();
+            }
+
+            r.label = id;
+            add_run(id, r);
+
+            // The last run above may also touch the next run
+            if (k > i) {
+                i = k - 1;
+            }
+        }
+
+        // Later merges in this row may have absorbed earlier runs'
+        // components, so resolve all runs to their final records
+        for (run& r : _current) {
+            r.label = root(r.label);
+            _records[r.label].row = stamp;
+        }
+
+        // Components of the previous row that this row does not touch are
+        // finished, since no later row can reach them
+        for (const run& r : _above) {
+            const std::size_t id = root(r.label);
+
+            if (_records[id].row != stamp) {
+                emit(id);
+                _records[id].row = stamp;
+            }
+        }
+
+        // Nothing refers to merged records anymore
+        _free.insert(_free.end(), _merged.begin(), _merged.end());
+        _merged.clear();
+
+        std::swap(_above, _current);
+        ++_row;
+
+        return _finished.size();
+    }
+
+    std::size_t stream_labeler::new_record() {
+        std::size_t id;
+
+        if (_free.empty()) {
+            id = _records.size();
+            _records.emplace_back();
+        } else {
+            id = _free.back();
+            _free.pop_back();
+        }
+
+        record& rec = _records[id];
+        rec.parent = id;
+        rec.area = 0;
+        rec.sum_x = 0.0;
+        rec.sum_y = 0.0;
+        rec.min_x = std::numeric_limits<std::size_t>::max();
+        rec.min_y = std::numeric_limits<std::size_t>::max();
+        rec.max_x = 0;
+        rec.max_y = 0;
+        rec.row = 0;
+
+        ++_live_count;
+
+        return id;
+    }
+
+    std::size_t stream_labeler::root(std::size_t id) {
+        // Path halving keeps the chains of merged records short
+        while (_records[id].parent != id) {
+            _records[id].parent = _records[_records[id].parent].parent;
+            id = _records[id].parent;
+        }
+
+        return id;
+    }
+
+    std::size_t stream_labeler::merge(std::size_t a, std::size_t b) {
+        a = root(a);
+        b = root(b);
+
+        if (a == b) {
+            return a;
+        }
+
+        record& into = _records[a];
+        record& from = _records[b];
+
+        into.area += from.area;
+        into.sum_x += from.sum_x;
+        into.sum_y += from.sum_y;
+        into.min_x = std::min(into.min_x, from.min_x);
+        into.min_y = std::min(into.min_y, from.min_y);
+        into.max_x = std::max(into.max_x, from.max_x);
+        into.max_y = std::max(into.max_y, from.max_y);
+        from.parent = a;
+
+        _merged.push_back(b);
+        --_live_count;
+
+        return a;
+    }
+
+    void stream_labeler::add_run(std::size_t id, const run& r) {
+        record& rec = _records[id];
+        const std::size_t length = r.end - r.start;
+
+        rec.area += length;
+        rec.sum_x += detail::run_coordinate_sum(r.start, r.end);
+        rec.sum_y += static_cast<double>(length) * static_cast<double>(_row);
+        rec.min_x = std::min(rec.min_x, r.start);
+        rec.min_y = std::min(rec.min_y, _row);
+        rec.max_x = std::max(rec.max_x, r.end - 1);
+        rec.max_y = std::max(rec.max_y, _row);
+    }
+
+    void stream_labeler::emit(std::size_t id) {
+        const record& rec = _records[id];
+        const float area = static_cast<float>(rec.area);
+
+        _finished.emplace_back(static_cast<unsigned int>(++_label_count));
+        connected_component& component = _finished.back();
+
+        point2f& centroid = detail::component_access::centroid(component);
+        rectangle2i& box = detail::component_access::bounding_box(component);
+
+        detail::component_access::area(component) = rec.area;
+        centroid.x = static_cast<float>(rec.sum_x) / area;
+        centroid.y = static_cast<float>(rec.sum_y) / area;
+        box.x = static_cast<int>(rec.min_x);
+        box.y = static_cast<int>(rec.min_y);
+        box.width = static_cast<int>(rec.max_x - rec.min_x + 1);
+        box.height = static_cast<int>(rec.max_y - rec.min_y + 1);
+
+        _free.push_back(id);
+        --_live_count;
+    }
+} // cvx
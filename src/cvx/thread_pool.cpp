@@ -0,0 +1,116 @@
+#include "cvx/thread_pool.hpp"
+#include <algorithm>
+
+namespace cvx {
+    thread_pool::thread_pool(std::size_t thread_count)
+        : _task(nullptr),
+          _count(0),
+          _next(0),
+          _finished(0),
+          _generation(0),
+          _stop(false) {
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // The thread calling parallel_for also runs tasks
+        for (std::size_t i = 1; i < thread_count; ++i) {
+            _threads.emplace_back(&thread_pool::work, this, i);
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+
+        _start.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t thread_pool::size() const noexcept {
+        return _threads.size() + 1;
+    }
+
+    void thread_pool::parallel_for(std::size_t count,
+                                   const std::function<void(std::size_t)>& task) {
+        parallel_for_worker(count, [&task](std::size_t i, std::size_t) {
+            task(i);
+        });
+    }
+
+    void thread_pool::parallel_for_worker(std::size_t count,
+                                          const std::function<void(std::size_t, std::size_t)>& task) {
+        // Only one batch of tasks can be in flight at a time
+        std::lock_guard<std::mutex> submit_lock(_submit_mutex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &task;
+            _count = count;
+            _next = 0;
+            _finished = 0;
+            _error = nullptr;
+            ++_generation;
+        }
+
+        _start.notify_all();
+        run_tasks(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _finished == _threads.size(); });
+        _task = nullptr;
+
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+
+    void thread_pool::work(std::size_t worker) {
+        std::size_t generation = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start.wait(lock, [this, generation] { return _stop || _generation != generation; });
+
+                if (_stop) {
+                    return;
+                }
+
+                generation = _generation;
+            }
+
+            run_tasks(worker);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (++_finished == _threads.size()) {
+                _done.notify_one();
+            }
+        }
+    }
+
+    void thread_pool::run_tasks(std::size_t worker) {
+        std::size_t i;
+
+        while ((i = _next.fetch_add(1)) < _count) {
+            try {
+                (*_task)(i, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                if (!_error) {
+                    _error = std::current_exception();
+                }
+
+                // Skip any remaining tasks
+                _next = _count;
+            }
+        }
+    }
+} // cvx
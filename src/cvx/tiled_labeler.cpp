@@ -0,0 +1,317 @@
+#include "cvx/tiled_labeler.hpp"
+#include "cvx/bit_view.hpp"
+#include "cvx/exception.hpp"
+#include "cvx/mapped_file.hpp"
+#include "cvx/union_find.hpp"
+#include "cvx/detail/pnm.hpp"
+#include "cvx/detail/twopass_label.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace cvx {
+    namespace {
+        using label_type = tiled_labeler::label_type;
+
+        // Views of the rows of a mapped tile of 8-bit pixels
+        struct byte_input {
+            const mapped_file& file;
+            std::size_t offset;
+            std::uint8_t background;
+
+            array_view<const std::uint8_t*> view(const std::uint8_t* data,
+                                                 std::size_t width,
+                                                 std::size_t rows,
+                                                 std::size_t stride) const {
+                return array_view<const std::uint8_t*>(data,
+                                                       data + stride * (rows - 1) + width,
+                                                       width,
+                                                       rows,
+                                                       stride);
+            }
+        };
+
+        // Views of the rows of a mapped tile of packed PBM pixels
+        struct bit_input {
+            const mapped_file& file;
+            std::size_t offset;
+            bool background;
+
+            bit_view view(const std::uint8_t* data,
+                          std::size_t width,
+                          std::size_t rows,
+                          std::size_t stride) const {
+                return make_bit_view(data, width, rows, stride, bit_order::msb_first);
+            }
+        };
+
+        // Worst-case bytes of labelling scratch for one row of a tile. A row
+        // holds at most width / 2 + 1 runs or provisional labels, each with
+        // a union-find entry and a relabelling table entry, and the run
+        // engine also stores the runs and the offset of the row's runs
+        std::size_t scratch_row_bytes(label_engine engine, std::size_t width) {
+            const std::size_t labels = width / 2 + 1;
+            std::size_t bytes = 2 * labels * sizeof(label_type);
+
+            if (engine == label_engine::run) {
+                bytes += labels * sizeof(detail::label_run<label_type>) + sizeof(std::size_t);
+            }
+
+            return bytes;
+        }
+
+        // Sorted distinct labels on the top and bottom rows of a tile
+        void collect_borders(const label_type* top,
+                             const label_type* bottom,
+                             std::size_t width,
+                             std::vector<label_type>& borders) {
+            borders.clear();
+
+            for (std::size_t x = 0; x < width; ++x) {
+                if (top[x]) {
+                    borders.push_back(top[x]);
+                }
+
+                if (bottom[x]) {
+                    borders.push_back(bottom[x]);
+                }
+            }
+
+            std::sort(borders.begin(), borders.end());
+            borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+        }
+
+        // Index of a border label of a tile in the global union-find
+        std::size_t border_element(const std::vector<label_type>& borders, std::size_t base, label_type label) {
+            return 1 + base + static_cast<std::size_t>(std::lower_bound(borders.begin(), borders.end(), label) -
+                                                       borders.begin());
+        }
+    } // anonymous
+
+    tiled_labeler::tiled_labeler(unsigned char connectivity, std::size_t tile_budget, label_engine engine)
+        : _connectivity(connectivity),
+          _tile_budget(tile_budget),
+          _engine(engine),
+          _tile_rows(0),
+          _tile_count(0),
+          _border_labels(0) {
+        if (connectivity != 4 && connectivity != 8) {
+            throw exception("Connectivity must be 4 or 8");
+        }
+    }
+
+    std::size_t tiled_labeler::label_file(const std::string& input_path, const std::string& output_path) {
+        const detail::pnm_header header = detail::read_pnm_header(input_path);
+        const mapped_file file(input_path);
+
+        if (detail::multiply_overflows(header.stride, header.height) ||
+            detail::add_overflows(header.offset, header.stride * header.height) ||
+            header.offset + header.stride * header.height > file.size()) {
+            throw exception("'" + input_path + "' is truncated");
+        }
+
+        if (header.format == detail::pnm_format::pbm) {
+            return label_tiles(bit_input{ file, header.offset, false },
+                               output_path,
+                               header.width,
+                               header.height,
+                               header.stride);
+        }
+
+        if (header.maxval > 255) {
+            throw exception("Only 8-bit PGM files can be labelled");
+        }
+
+        return label_tiles(byte_input{ file, header.offset, 0 },
+                           output_path,
+                           header.width,
+                           header.height,
+                           header.stride);
+    }
+
+    std::size_t tiled_labeler::label_raw_file(const std::string& input_path,
+                                              const std::string& output_path,
+                                              std::size_t width,
+                                              std::size_t height,
+                                              std::uint8_t background) {
+        const mapped_file file(input_path);
+
+        if (width == 0 || height == 0) {
+            throw exception("Image must have pixels");
+        }
+
+        if (detail::multiply_overflows(width, height) || width * height > file.size()) {
+            throw exception("'" + input_path + "' is smaller than the image");
+        }
+
+        return label_tiles(byte_input{ file, 0, background }, output_path, width, height, width);
+    }
+
+    std::size_t tiled_labeler::tile_rows() const noexcept {
+        return _tile_rows;
+    }
+
+    std::size_t tiled_labeler::tile_count() const noexcept {
+        return _tile_count;
+    }
+
+    std::size_t tiled_labeler::border_labels() const noexcept {
+        return _border_labels;
+    }
+
+    template<typename Input>
+    std::size_t tiled_labeler::label_tiles(const Input& input,
+                                           const std::string& output_path,
+                                           std::size_t width,
+                                           std::size_t height,
+                                           std::size_t stride) {
+        if (detail::multiply_overflows(width, height) ||
+            detail::multiply_overflows(width * height, sizeof(label_type))) {
+            throw exception("Image is too large to label");
+        }
+
+        // Per row: the mapped input and output, and the worst-case scratch
+        // of the engine. The scratch is reserved up front, so its vectors do
+        // not grow past the budget when they reallocate
+        const std::size_t row_scratch = scratch_row_bytes(_engine, width);
+        const std::size_t row_bytes = stride + width * sizeof(label_type) + row_scratch;
+        const std::size_t rows = std::min(height, std::max<std::size_t>(1, _tile_budget / row_bytes));
+        const std::size_t tile_count = (height + rows - 1) / rows;
+        const std::size_t reach = (_connectivity == 8 ? 1 : 0);
+        const std::size_t tile_labels_bound = rows * (width / 2 + 1);
+
+        mapped_file output = mapped_file::create(output_path, width * height * sizeof(label_type));
+
+        detail::two_pass_scratch<label_type> scratch;
+        scratch.labels = union_find<label_type>(tile_labels_bound + 1);
+        scratch.order.reserve(tile_labels_bound + 1);
+
+        if (_engine == label_engine::run) {
+            scratch.runs.reserve(tile_labels_bound);
+            scratch.row_runs.reserve(rows + 1);
+        }
+
+        union_find<std::size_t> borders_uf;
+        std::vector<std::size_t> bases(tile_count + 1);
+        std::vector<std::size_t> counts(tile_count);
+        std::vector<label_type> tile_borders;
+        std::vector<label_type> above_borders;
+        std::vector<label_type> above;
+
+        // 1. Label each tile on its own and merge the border labels of
+        //    adjacent tiles
+        for (std::size_t t = 0; t < tile_count; ++t) {
+            const std::size_t y = t * rows;
+            const std::size_t tile_height = std::min(rows, height - y);
+
+            const mapped_region in(input.file,
+                                   input.offset + y * stride,
+                                   tile_height * stride,
+                                   false,
+                                   access_hint::sequential);
+
+            const mapped_region out(output,
+                                    y * width * sizeof(label_type),
+                                    tile_height * width * sizeof(label_type),
+                                    true,
+                                    access_hint::sequential);
+
+            label_type* labels = reinterpret_cast<label_type*>(out.data());
+            const auto tile = input.view(in.data(), width, tile_height, stride);
+            array_view<label_type*> tile_labels(labels, labels + width * tile_height, width, tile_height);
+
+            counts[t] = detail::two_pass_label(tile, tile_labels, _connectivity, input.background, _engine, scratch);
+
+            // Labels on the top or bottom row may continue in another tile
+            const label_type* top = labels;
+            const label_type* bottom = labels + (tile_height - 1) * width;
+
+            collect_borders(top, bottom, width, tile_borders);
+
+            bases[t] = borders_uf.size() - 1;
+
+            for (std::size_t i = 0; i < tile_borders.size(); ++i) {
+                borders_uf.new_label();
+            }
+
+            if (t > 0) {
+                for (std::size_t x = 0; x < width; ++x) {
+                    if (!top[x]) {
+                        continue;
+                    }
+
+                    const std::size_t element = border_element(tile_borders, bases[t], top[x]);
+                    const std::size_t first = (x >= reach ? x - reach : 0);
+                    const std::size_t last = std::min(width - 1, x + reach);
+
+                    for (std::size_t ax = first; ax <= last; ++ax) {
+                        if (above[ax]) {
+                            borders_uf.merge(border_element(above_borders, bases[t - 1], above[ax]), element);
+                        }
+                    }
+                }
+            }
+
+            above.assign(bottom, bottom + width);
+            above_borders.swap(tile_borders);
+        }
+
+        bases[tile_count] = borders_uf.size() - 1;
+        borders_uf.flatten();
+
+        const std::size_t border_count = borders_uf.label_count();
+        std::vector<std::size_t> interior_offsets(tile_count);
+        std::size_t label_count = border_count;
+
+        for (std::size_t t = 0; t < tile_count; ++t) {
+            interior_offsets[t] = label_count;
+            label_count += counts[t] - (bases[t + 1] - bases[t]);
+        }
+
+        if (label_count > static_cast<std::size_t>(std::numeric_limits<label_type>::max())) {
+            throw exception("Too many components for 32-bit labels");
+        }
+
+        // 2. Rewrite each tile with the final labels. The border labels of
+        //    a tile are read back from its top and bottom rows, so they do
+        //    not have to be kept for every tile
+        std::vector<label_type> table;
+
+        for (std::size_t t = 0; t < tile_count; ++t) {
+            const std::size_t y = t * rows;
+            const std::size_t tile_height = std::min(rows, height - y);
+
+            const mapped_region out(output,
+                                    y * width * sizeof(label_type),
+                                    tile_height * width * sizeof(label_type),
+                                    true,
+                                    access_hint::sequential);
+
+            label_type* labels = reinterpret_cast<label_type*>(out.data());
+            std::size_t j = 0;
+
+            collect_borders(labels, labels + (tile_height - 1) * width, width, tile_borders);
+
+            table.assign(counts[t] + 1, 0);
+
+            for (std::size_t label = 1; label <= counts[t]; ++label) {
+                if (j < tile_borders.size() && tile_borders[j] == label) {
+                    table[label] = static_cast<label_type>(borders_uf.get(1 + bases[t] + j));
+                    ++j;
+                } else {
+                    table[label] = static_cast<label_type>(interior_offsets[t] + label - j);
+                }
+            }
+
+            for (label_type* p = labels; p != labels + width * tile_height; ++p) {
+                *p = table[*p];
+            }
+        }
+
+        _tile_rows = rows;
+        _tile_count = tile_count;
+        _border_labels = borders_uf.size() - 1;
+
+        return label_count;
+    }
+} // cvx
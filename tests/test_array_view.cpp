@@ -1,3 +1,6 @@
+// Check the bounds of the unchecked row access
+#define CVX_CHECK_BOUNDS
+
 #include <cvx.hpp>
 #include <assert.h>
 #include <iterator>
@@ -43,6 +46,9 @@ int main() {
         assert(short_view(3, 10) == 915);
         assert(short_view(cvx::point2<char>(8, 0)) == -259);
         assert(short_view.row(4) == short_array[4]);
+        assert(short_view.row_begin(4) == short_array[4]);
+        assert(short_view.row_end(4) == std::end(short_array[4]));
+        assert(short_view.row_begin(7)[11] == 236);
         assert(short_view.width() == 12);
         assert(short_view.height() == 8);
         assert(short_view.pitch() == 12 * sizeof(short));
@@ -75,6 +81,16 @@ int main() {
         assert(int_view.begin() == std::begin(int_array[0]));
         assert(int_view.end() == &int_array[14][6]);
         assert(int_view.end() == std::end(int_array[14]));
+
+        bool thrown = false;
+
+        try {
+            int_view.row_begin(15);
+        } catch (cvx::exception&) {
+            thrown = true;
+        }
+
+        assert(thrown);
     } catch (cvx::exception& ex) {
         std::cerr << "Error: " << ex.what() << std::endl;
         return 1;
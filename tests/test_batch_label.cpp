@@ -0,0 +1,119 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+int main() {
+    const std::size_t patch_count = 200;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 64);
+    std::bernoulli_distribution dist(0.45);
+
+    // Patches of different sizes
+    std::vector<std::vector<int>> images(patch_count);
+    std::vector<std::size_t> widths(patch_count);
+    std::vector<std::size_t> heights(patch_count);
+
+    for (std::size_t i = 0; i < patch_count; ++i) {
+        widths[i] = size_dist(rng);
+        heights[i] = size_dist(rng);
+        images[i].resize(widths[i] * heights[i]);
+
+        for (auto& e : images[i]) {
+            e = dist(rng) ? 1 : 0;
+        }
+    }
+
+    try {
+        const cvx::feature_flag flags = cvx::feature_flag::area | cvx::feature_flag::bounding_box;
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            std::vector<std::vector<int>> labels(patch_count);
+            std::vector<cvx::array_view<std::vector<int>::iterator>> inputs;
+            std::vector<cvx::array_view<std::vector<int>::iterator>> outputs;
+
+            for (std::size_t i = 0; i < patch_count; ++i) {
+                labels[i].resize(images[i].size());
+                inputs.emplace_back(images[i].begin(), images[i].end(), widths[i], heights[i]);
+                outputs.emplace_back(labels[i].begin(), labels[i].end(), widths[i], heights[i]);
+            }
+
+            cvx::thread_pool pool(4);
+            cvx::batch_labeler<int> batch(pool, connectivity, flags);
+
+            // The second batch reuses the workspaces of the first
+            for (int pass = 0; pass < 2; ++pass) {
+                const std::size_t total = batch.label(inputs.begin(), inputs.end(), outputs.begin(), 1, 0);
+                std::size_t expected_total = 0;
+
+                assert(batch.counts().size() == patch_count);
+                assert(batch.components().size() == patch_count);
+
+                for (std::size_t i = 0; i < patch_count; ++i) {
+                    std::vector<int> expected(images[i].size());
+                    std::vector<cvx::connected_component> expected_ccs;
+
+                    const std::size_t count = cvx::label_connected_components(images[i].begin(),
+                                                                              images[i].end(),
+                                                                              expected.begin(),
+                                                                              expected.end(),
+                                                                              std::back_inserter(expected_ccs),
+                                                                              widths[i],
+                                                                              heights[i],
+                                                                              connectivity,
+                                                                              1,
+                                                                              0,
+                                                                              flags);
+                    expected_total += count;
+
+                    assert(batch.counts()[i] == count);
+                    assert(labels[i] == expected);
+
+                    const auto& ccs = batch.components()[i];
+                    assert(ccs.size() == expected_ccs.size());
+
+                    for (std::size_t j = 0; j < ccs.size(); ++j) {
+                        assert(ccs[j].label() == expected_ccs[j].label());
+                        assert(ccs[j].area() == expected_ccs[j].area());
+
+                        cvx::rectangle2i box = ccs[j].bounding_box();
+                        assert(box == expected_ccs[j].bounding_box());
+                    }
+                }
+
+                assert(total == expected_total);
+            }
+
+            // Components moved into an output iterator per image
+            std::vector<std::vector<cvx::connected_component>> moved(patch_count);
+            std::vector<std::back_insert_iterator<std::vector<cvx::connected_component>>> outs;
+
+            for (auto& ccs : moved) {
+                outs.push_back(std::back_inserter(ccs));
+            }
+
+            const std::vector<std::vector<cvx::connected_component>> kept(batch.components());
+            const std::size_t total = batch.label(inputs.begin(), inputs.end(), outputs.begin(), outs.begin(), 1, 0);
+            std::size_t moved_total = 0;
+
+            for (std::size_t i = 0; i < patch_count; ++i) {
+                assert(moved[i].size() == kept[i].size());
+                assert(batch.components()[i].empty());
+                moved_total += moved[i].size();
+
+                for (std::size_t j = 0; j < moved[i].size(); ++j) {
+                    assert(moved[i][j].area() == kept[i][j].area());
+                }
+            }
+
+            assert(total == moved_total);
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
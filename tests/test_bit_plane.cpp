@@ -0,0 +1,44 @@
+#include <cvx.hpp>
+#include <assert.h>
+
+int main() {
+    cvx::bit_plane plane(70, 3);
+
+    assert(plane.width() == 70);
+    assert(plane.height() == 3);
+
+    for (std::size_t y = 0; y < plane.height(); ++y) {
+        for (std::size_t x = 0; x < plane.width(); ++x) {
+            assert(!plane.test(x, y));
+        }
+    }
+
+    // Bits on both sides of a word boundary
+    plane.set(63, 0);
+    plane.set(64, 0);
+    plane.set(69, 2);
+
+    assert(plane.test(63, 0));
+    assert(plane.test(64, 0));
+    assert(plane.test(69, 2));
+    assert(!plane.test(62, 0));
+    assert(!plane.test(65, 0));
+    assert(!plane.test(63, 1));
+
+    // Reusing the plane clears it
+    plane.reset(5, 5);
+
+    assert(plane.width() == 5);
+    assert(plane.height() == 5);
+
+    for (std::size_t y = 0; y < plane.height(); ++y) {
+        for (std::size_t x = 0; x < plane.width(); ++x) {
+            assert(!plane.test(x, y));
+        }
+    }
+
+    plane.set(4, 4);
+    assert(plane.test(4, 4));
+
+    return 0;
+}
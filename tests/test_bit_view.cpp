@@ -0,0 +1,125 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Pack a binary image with padding bytes at the end of each row
+std::vector<std::uint8_t> pack(const std::vector<int>& image,
+                               std::size_t width,
+                               std::size_t height,
+                               std::size_t stride,
+                               cvx::bit_order order) {
+    std::vector<std::uint8_t> packed(stride * height, 0);
+
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            if (image[y * width + x]) {
+                const unsigned int bit = (order == cvx::bit_order::msb_first ? 7 - x % 8 : x % 8);
+                packed[y * stride + x / 8] |= static_cast<std::uint8_t>(1u << bit);
+            }
+        }
+
+        // Set the padding bits, they must be ignored
+        if (width % 8) {
+            const unsigned int bits = width % 8;
+            const std::uint8_t padding = (order == cvx::bit_order::msb_first ? 0xff >> bits : 0xff << bits);
+            packed[y * stride + width / 8] |= padding;
+        }
+    }
+
+    return packed;
+}
+
+int main() {
+    std::mt19937 rng(23);
+
+    try {
+        for (std::size_t width : { 1, 7, 64, 131 }) {
+            const std::size_t height = 37;
+            const std::size_t stride = (width + 7) / 8 + 3;
+
+            for (double density : { 0.05, 0.5, 0.95 }) {
+                std::bernoulli_distribution dist(density);
+                std::vector<int> image(width * height);
+
+                for (auto& e : image) {
+                    e = dist(rng) ? 1 : 0;
+                }
+
+                for (auto order : { cvx::bit_order::msb_first, cvx::bit_order::lsb_first }) {
+                    const std::vector<std::uint8_t> packed = pack(image, width, height, stride, order);
+                    const cvx::bit_view view = cvx::make_bit_view(packed.data(), width, height, stride, order);
+
+                    for (std::size_t i = 0; i < image.size(); ++i) {
+                        assert(view.cbegin()[i] == (image[i] != 0));
+                    }
+
+                    for (unsigned char connectivity : { 4, 8 }) {
+                        std::vector<int> expected(image);
+                        std::vector<cvx::connected_component> expected_components;
+                        auto expected_count = cvx::label_connected_components(expected.begin(),
+                                                                              expected.end(),
+                                                                              std::back_inserter(expected_components),
+                                                                              width,
+                                                                              height,
+                                                                              connectivity,
+                                                                              1,
+                                                                              0,
+                                                                              cvx::feature_flag::area |
+                                                                              cvx::feature_flag::bounding_box);
+
+                        for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::run }) {
+                            std::vector<int> labels(width * height, -1);
+                            auto ccs = cvx::label_connected_components(view.cbegin(),
+                                                                       view.cend(),
+                                                                       labels.begin(),
+                                                                       labels.end(),
+                                                                       width,
+                                                                       height,
+                                                                       connectivity,
+                                                                       true,
+                                                                       false,
+                                                                       engine);
+
+                            assert(ccs == expected_count);
+                            assert(labels == expected);
+
+                            std::vector<cvx::connected_component> components;
+                            std::fill(labels.begin(), labels.end(), -1);
+                            ccs = cvx::label_connected_components(view.cbegin(),
+                                                                  view.cend(),
+                                                                  labels.begin(),
+                                                                  labels.end(),
+                                                                  std::back_inserter(components),
+                                                                  width,
+                                                                  height,
+                                                                  connectivity,
+                                                                  true,
+                                                                  false,
+                                                                  cvx::feature_flag::area |
+                                                                  cvx::feature_flag::bounding_box,
+                                                                  engine);
+
+                            assert(ccs == expected_count);
+                            assert(labels == expected);
+
+                            for (std::size_t i = 0; i < components.size(); ++i) {
+                                assert(components[i].size() == expected_components[i].size());
+                                assert(components[i].bounding_box() == expected_components[i].bounding_box());
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Reference labelling by flood filling each component in raster order
+std::size_t flood_label(std::vector<int>& image, int width, int height) {
+    std::vector<int> stack;
+    int label = 0;
+
+    for (int i = 0; i < width * height; ++i) {
+        if (image[i] != 1) {
+            continue;
+        }
+
+        ++label;
+        image[i] = -label;
+        stack.push_back(i);
+
+        while (!stack.empty()) {
+            int j = stack.back();
+            stack.pop_back();
+
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int x = j % width + dx;
+                    int y = j / width + dy;
+
+                    if (x >= 0 && x < width && y >= 0 && y < height && image[y * width + x] == 1) {
+                        image[y * width + x] = -label;
+                        stack.push_back(y * width + x);
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto& e : image) {
+        e = -e;
+    }
+
+    return label;
+}
+
+int main() {
+    const int width = 25;
+    const int height = 9;
+
+    int input[][25] = { {1, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+                        {0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0},
+                        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 1, 0},
+                        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0},
+                        {0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 1, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0},
+                        {0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 0},
+                        {0, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+                        {0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+                        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0} };
+
+    const int expected[][25] = { {1, 0, 0, 0, 0, 0, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 0, 0, 0, 0},
+                                 {0, 1, 0, 0, 0, 0, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 3, 0, 0, 0, 0},
+                                 {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 0, 3, 3, 0, 0, 0, 5, 0},
+                                 {0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 5, 0},
+                                 {0, 0, 6, 6, 6, 0, 0, 7, 7, 7, 0, 0, 4, 0, 8, 0, 4, 0, 9, 9, 0, 0, 5, 5, 0},
+                                 {0, 0, 0, 6, 0, 0, 7, 7, 7, 7, 0, 0, 4, 0, 0, 0, 4, 0, 0, 9, 9, 0, 5, 5, 0},
+                                 {0, 0, 6, 0, 6, 0, 0, 0, 0, 7, 0, 0, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0},
+                                 {0, 0, 6, 6, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                 {0, 0, 6, 0, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0} };
+
+    auto input_begin = std::begin(input[0]);
+    auto input_end = std::end(input[height - 1]);
+    auto expected_begin = std::begin(expected[0]);
+
+    try {
+        auto ccs = cvx::label_connected_components(input_begin,
+                                                   input_end,
+                                                   width,
+                                                   height,
+                                                   8,
+                                                   1,
+                                                   0,
+                                                   cvx::label_engine::block);
+
+        assert(ccs == 9);
+        assert(std::equal(input_begin, input_end, expected_begin));
+
+        // Compare against the pixel-based engine and a flood fill on random
+        // images of both even and odd dimensions and varying densities
+        std::mt19937 rng(1234);
+        const int sizes[][2] = { {2, 2}, {3, 5}, {8, 8}, {17, 4}, {31, 33}, {64, 63}, {2, 97}, {101, 2} };
+        const double densities[] = { 0.1, 0.3, 0.5, 0.7, 0.9 };
+
+        for (auto& size : sizes) {
+            for (double density : densities) {
+                std::bernoulli_distribution dist(density);
+                const int w = size[0];
+                const int h = size[1];
+                std::vector<int> image(w * h);
+
+                for (auto& e : image) {
+                    e = dist(rng) ? 1 : 0;
+                }
+
+                std::vector<int> pixel(image), block(image), reference(image);
+
+                auto pixel_count = cvx::label_connected_components(pixel.begin(), pixel.end(), w, h, 8, 1, 0);
+                auto block_count = cvx::label_connected_components(block.begin(),
+                                                                   block.end(),
+                                                                   w,
+                                                                   h,
+                                                                   8,
+                                                                   1,
+                                                                   0,
+                                                                   cvx::label_engine::block);
+                auto reference_count = flood_label(reference, w, h);
+
+                assert(block_count == reference_count);
+                assert(pixel_count == reference_count);
+                assert(block == reference);
+                assert(pixel == reference);
+            }
+        }
+
+        // Single rows and columns are only handled by the block engine
+        int column[] = { 1, 1, 0, 1, 0, 0, 1, 1, 1 };
+        const int expected_column[] = { 1, 1, 0, 2, 0, 0, 3, 3, 3 };
+
+        ccs = cvx::label_connected_components(std::begin(column),
+                                              std::end(column),
+                                              1,
+                                              9,
+                                              8,
+                                              1,
+                                              0,
+                                              cvx::label_engine::block);
+
+        assert(ccs == 3);
+        assert(std::equal(std::begin(column), std::end(column), std::begin(expected_column)));
+
+        // Extracting features with the block engine
+        std::vector<int> image(std::begin(expected[0]), std::end(expected[height - 1]));
+
+        for (auto& e : image) {
+            e = e ? 1 : 0;
+        }
+
+        std::vector<cvx::connected_component> components;
+        ccs = cvx::label_connected_components(image.begin(),
+                                              image.end(),
+                                              std::back_inserter(components),
+                                              width,
+                                              height,
+                                              8,
+                                              1,
+                                              0,
+                                              cvx::feature_flag::area,
+                                              cvx::label_engine::block);
+
+        assert(ccs == 9);
+        assert(std::equal(image.begin(), image.end(), expected_begin));
+        assert(components.size() == 9);
+        assert(components[0].area() == 2);
+        assert(components[3].area() == 16);
+        assert(components[7].area() == 1);
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
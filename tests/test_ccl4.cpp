@@ -1,5 +1,6 @@
 #include <cvx.hpp>
 #include <assert.h>
+#include <iostream>
 #include <iterator>
 #include <type_traits>
 
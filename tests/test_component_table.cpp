@@ -0,0 +1,144 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Check a table against the components extracted by the flags
+void check_table(const cvx::component_table& table, const std::vector<cvx::connected_component>& components) {
+    assert(table.size() == components.size());
+
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        cvx::rectangle2i box = table.bounding_box(i);
+
+        assert(table.label(i) == components[i].label());
+        assert(table.area(i) == components[i].area());
+        assert(table.areas()[i] == components[i].area());
+        assert(box == components[i].bounding_box());
+        assert(std::fabs(table.centroid(i).x - components[i].centroid().x) < 1e-3);
+        assert(std::fabs(table.centroid(i).y - components[i].centroid().y) < 1e-3);
+    }
+}
+
+int main() {
+    const std::size_t width = 83;
+    const std::size_t height = 61;
+    const cvx::feature_flag flags = cvx::feature_flag::area | cvx::feature_flag::centroid | cvx::feature_flag::bounding_box;
+    std::mt19937 rng(5);
+
+    try {
+        for (double density : { 0.3, 0.6 }) {
+            std::bernoulli_distribution dist(density);
+            std::vector<int> image(width * height);
+
+            for (auto& e : image) {
+                e = dist(rng) ? 1 : 0;
+            }
+
+            for (unsigned char connectivity : { 4, 8 }) {
+                for (cvx::label_engine engine : { cvx::label_engine::pixel, cvx::label_engine::block, cvx::label_engine::run }) {
+                    std::vector<int> expected(image.size());
+                    std::vector<cvx::connected_component> components;
+
+                    const std::size_t expected_count = cvx::label_connected_components(image.begin(),
+                                                                                       image.end(),
+                                                                                       expected.begin(),
+                                                                                       expected.end(),
+                                                                                       std::back_inserter(components),
+                                                                                       width,
+                                                                                       height,
+                                                                                       connectivity,
+                                                                                       1,
+                                                                                       0,
+                                                                                       flags,
+                                                                                       engine);
+
+                    // Separate label image
+                    std::vector<int> labels(image.size());
+                    cvx::component_table table;
+
+                    std::size_t count = cvx::label_connected_components(image.begin(),
+                                                                        image.end(),
+                                                                        labels.begin(),
+                                                                        labels.end(),
+                                                                        table,
+                                                                        width,
+                                                                        height,
+                                                                        connectivity,
+                                                                        1,
+                                                                        0,
+                                                                        engine);
+
+                    assert(count == expected_count);
+                    assert(labels == expected);
+                    check_table(table, components);
+
+                    // In place, reusing the table
+                    std::vector<int> in_place(image);
+
+                    count = cvx::label_connected_components(in_place.begin(),
+                                                            in_place.end(),
+                                                            table,
+                                                            width,
+                                                            height,
+                                                            connectivity,
+                                                            1,
+                                                            0,
+                                                            engine);
+
+                    assert(count == expected_count);
+                    assert(in_place == expected);
+                    check_table(table, components);
+
+                    // With a labeler
+                    cvx::labeler<int> labeler(connectivity, cvx::feature_flag::none, engine);
+                    cvx::array_view<std::vector<int>::iterator> input(image.begin(), image.end(), width, height);
+                    cvx::array_view<std::vector<int>::iterator> output(labels.begin(), labels.end(), width, height);
+
+                    for (int pass = 0; pass < 2; ++pass) {
+                        table.clear();
+                        assert(table.empty());
+                        assert(labeler.label(input, output, 1, 0, table) == expected_count);
+                        check_table(table, components);
+                    }
+                }
+            }
+        }
+
+        // Provisional labels overflow unsigned char, but the final ones fit:
+        // stripes joined by the bottom row
+        const std::size_t comb_width = 601;
+        const std::size_t comb_height = 4;
+        std::vector<unsigned char> comb(comb_width * comb_height, 0);
+
+        for (std::size_t x = 0; x < comb_width; x += 2) {
+            for (std::size_t y = 0; y < comb_height; ++y) {
+                comb[y * comb_width + x] = 1;
+            }
+        }
+
+        std::fill(comb.end() - comb_width, comb.end(), 1);
+
+        cvx::component_table table;
+        auto count = cvx::label_connected_components(comb.begin(),
+                                                     comb.end(),
+                                                     table,
+                                                     comb_width,
+                                                     comb_height,
+                                                     4,
+                                                     1,
+                                                     0);
+
+        assert(count == 1);
+        assert(table.size() == 1);
+        assert(table.area(0) == 301 * 3 + comb_width);
+        assert(table.bounding_box(0) == cvx::rectangle2i(0, 0, comb_width, comb_height));
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
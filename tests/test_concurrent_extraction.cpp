@@ -0,0 +1,77 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Label the same kind of image on many threads at once with the runtime
+// extractors, which used to be shared between all callers
+std::size_t label(const std::vector<int>& image,
+                  std::size_t width,
+                  std::size_t height,
+                  std::vector<cvx::connected_component>& components) {
+    std::vector<int> labels(image);
+
+    return cvx::label_connected_components(labels.begin(),
+                                           labels.end(),
+                                           std::back_inserter(components),
+                                           width,
+                                           height,
+                                           8,
+                                           1,
+                                           0,
+                                           cvx::feature_flag::centroid | cvx::feature_flag::points);
+}
+
+int main() {
+    const std::size_t width = 80;
+    const std::size_t height = 60;
+    const std::size_t thread_count = 8;
+    std::mt19937 rng(17);
+    std::bernoulli_distribution dist(0.5);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    std::vector<cvx::connected_component> expected;
+    const std::size_t expected_count = label(image, width, height, expected);
+
+    std::vector<std::vector<cvx::connected_component>> results(thread_count);
+    std::vector<std::size_t> counts(thread_count, 0);
+    std::vector<std::thread> threads;
+
+    try {
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&, i]() {
+                for (int repeat = 0; repeat < 20; ++repeat) {
+                    results[i].clear();
+                    counts[i] = label(image, width, height, results[i]);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        assert(counts[i] == expected_count);
+        assert(results[i].size() == expected.size());
+
+        for (std::size_t j = 0; j < expected.size(); ++j) {
+            assert(results[i][j].size() == expected[j].size());
+            assert(results[i][j].points() == expected[j].points());
+            assert(results[i][j].centroid() == expected[j].centroid());
+        }
+    }
+
+    return 0;
+}
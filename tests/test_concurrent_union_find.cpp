@@ -0,0 +1,73 @@
+#include <cvx.hpp>
+#include <cvx/concurrent_union_find.hpp>
+#include <cvx/union_find.hpp>
+#include <assert.h>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+int main() {
+    const int label_count = 5000;
+    const int merge_count = 4000;
+    const int thread_count = 4;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(1, label_count - 1);
+    std::vector<std::pair<int, int>> merges;
+
+    for (int i = 0; i < merge_count; ++i) {
+        merges.emplace_back(dist(rng), dist(rng));
+    }
+
+    // Sequential reference
+    cvx::union_find<int> expected;
+
+    for (int i = 1; i < label_count; ++i) {
+        expected.push_back(i);
+    }
+
+    for (auto& m : merges) {
+        expected.merge(m.first, m.second);
+    }
+
+    expected.flatten();
+
+    // Every thread merges the same pairs in a different order to provoke
+    // as many conflicting links as possible
+    cvx::concurrent_union_find<int> labels(label_count);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&labels, &merges, t]() {
+            for (std::size_t i = 0; i < merges.size(); ++i) {
+                const auto& m = merges[(i * (t + 1) * 7919) % merges.size()];
+
+                if (t % 2) {
+                    labels.merge(m.first, m.second);
+                } else {
+                    labels.merge(m.second, m.first);
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& m : merges) {
+        assert(labels.same(m.first, m.second));
+        assert(labels.root(m.first) == labels.find(m.second));
+    }
+
+    labels.flatten();
+
+    assert(labels.label_count() == expected.label_count());
+
+    for (int i = 0; i < label_count; ++i) {
+        assert(labels.get(i) == expected.get(i));
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Compile the trace hook into this test regardless of the build option
+#define CVX_TRACE_CONTOURS
+
+#include <cvx.hpp>
+#include <assert.h>
+#include <iterator>
+#include <random>
+#include <vector>
+
+std::vector<cvx::contour_trace> traces;
+
+void record(const cvx::contour_trace& trace) {
+    traces.push_back(trace);
+}
+
+int main() {
+    // Isolated points, each of which is a complete contour
+    int input[][6] = { {0, 0, 0, 0, 0, 0},
+                       {0, 1, 0, 0, 1, 0},
+                       {0, 0, 0, 0, 0, 0},
+                       {0, 0, 0, 0, 0, 0},
+                       {0, 1, 0, 0, 0, 0},
+                       {0, 0, 0, 0, 0, 0} };
+
+    cvx::set_contour_trace_hook(record);
+
+    std::vector<cvx::connected_component> components;
+    auto ccs = cvx::label_connected_components(std::begin(input[0]),
+                                               std::end(input[5]),
+                                               std::back_inserter(components),
+                                               6,
+                                               6,
+                                               8,
+                                               1,
+                                               0,
+                                               cvx::feature_flag::outer_contours);
+
+    assert(ccs == 3);
+    assert(traces.size() == 3);
+    assert(traces[0].start == cvx::point2i(1, 1));
+    assert(traces[1].start == cvx::point2i(4, 1));
+    assert(traces[2].start == cvx::point2i(1, 4));
+
+    for (auto& trace : traces) {
+        assert(trace.external);
+        assert(trace.length == 1);
+        assert(trace.steps == 8);
+    }
+
+    // No more reports once the hook is removed
+    cvx::set_contour_trace_hook(nullptr);
+    input[1][1] = 1;
+    input[1][4] = 1;
+    input[4][1] = 1;
+
+    cvx::label_connected_components(std::begin(input[0]),
+                                    std::end(input[5]),
+                                    std::back_inserter(components),
+                                    6,
+                                    6,
+                                    8,
+                                    1,
+                                    0,
+                                    cvx::feature_flag::outer_contours);
+
+    assert(traces.size() == 3);
+
+    // The outer contour of a ring visits every element once, clockwise
+    int ring[][6] = { {0, 0, 0, 0, 0, 0},
+                      {0, 1, 1, 1, 1, 0},
+                      {0, 1, 0, 0, 1, 0},
+                      {0, 1, 1, 1, 1, 0},
+                      {0, 0, 0, 0, 0, 0} };
+
+    std::vector<int> labels(30);
+    components.clear();
+
+    ccs = cvx::label_connected_components(std::begin(ring[0]),
+                                          std::end(ring[4]),
+                                          labels.begin(),
+                                          labels.end(),
+                                          std::back_inserter(components),
+                                          6,
+                                          5,
+                                          8,
+                                          1,
+                                          0,
+                                          cvx::feature_flag::all_contours);
+
+    const std::vector<cvx::point2i> contour = { {1, 1}, {2, 1}, {3, 1}, {4, 1}, {4, 2},
+                                                {4, 3}, {3, 3}, {2, 3}, {1, 3}, {1, 2} };
+
+    assert(ccs == 1);
+    assert(components[0].contour() == contour);
+
+    // Tracing terminates on arbitrary shapes and labels them like the
+    // two-pass algorithm
+    std::mt19937 rng(3);
+
+    for (int i = 0; i < 100; ++i) {
+        const std::size_t width = 1 + rng() % 40;
+        const std::size_t height = 1 + rng() % 40;
+        std::bernoulli_distribution dist((1 + rng() % 9) / 10.0);
+        std::vector<int> image(width * height);
+        std::vector<int> contour_labels(image.size());
+        std::vector<int> expected(image.size());
+
+        for (auto& e : image) {
+            e = dist(rng) ? 1 : 0;
+        }
+
+        components.clear();
+
+        auto count = cvx::label_connected_components(image.begin(),
+                                                     image.end(),
+                                                     contour_labels.begin(),
+                                                     contour_labels.end(),
+                                                     std::back_inserter(components),
+                                                     width,
+                                                     height,
+                                                     8,
+                                                     1,
+                                                     0,
+                                                     cvx::feature_flag::all_contours);
+
+        auto expected_count = cvx::label_connected_components(image.begin(),
+                                                              image.end(),
+                                                              expected.begin(),
+                                                              expected.end(),
+                                                              width,
+                                                              height,
+                                                              8,
+                                                              1,
+                                                              0);
+
+        assert(count == expected_count);
+        assert(contour_labels == expected);
+    }
+
+    return 0;
+}
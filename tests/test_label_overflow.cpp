@@ -0,0 +1,238 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// A comb whose teeth each get their own provisional label, but which is a
+// single connected component through its spine
+std::vector<unsigned char> make_comb(std::size_t width, std::size_t height) {
+    std::vector<unsigned char> image(width * height, 0);
+
+    for (std::size_t y = 0; y < height - 1; ++y) {
+        for (std::size_t x = 0; x < width; x += 2) {
+            image[y * width + x] = 1;
+        }
+    }
+
+    for (std::size_t x = 0; x < width; ++x) {
+        image[(height - 1) * width + x] = 1;
+    }
+
+    return image;
+}
+
+// Isolated 2x2 blobs on a grid, one connected component each
+std::vector<unsigned char> make_blobs(std::size_t count, std::size_t columns) {
+    const std::size_t width = 3 * columns;
+    const std::size_t height = 3 * ((count + columns - 1) / columns);
+    std::vector<unsigned char> image(width * height, 0);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t x = 3 * (i % columns);
+        const std::size_t y = 3 * (i / columns);
+
+        image[y * width + x] = image[y * width + x + 1] = 1;
+        image[(y + 1) * width + x] = image[(y + 1) * width + x + 1] = 1;
+    }
+
+    return image;
+}
+
+int main() {
+    const std::size_t width = 700;
+    const std::size_t height = 4;
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::block }) {
+                // More than 255 provisional labels, but only one component
+                std::vector<unsigned char> image = make_comb(width, height);
+                std::vector<unsigned char> expected(image);
+
+                auto ccs = cvx::label_connected_components(image.begin(),
+                                                           image.end(),
+                                                           width,
+                                                           height,
+                                                           connectivity,
+                                                           1,
+                                                           0,
+                                                           engine);
+
+                assert(ccs == 1);
+                assert(image == expected);
+
+                // Same with feature extraction
+                image = make_comb(width, height);
+                std::vector<cvx::connected_component> components;
+
+                ccs = cvx::label_connected_components(image.begin(),
+                                                      image.end(),
+                                                      std::back_inserter(components),
+                                                      width,
+                                                      height,
+                                                      connectivity,
+                                                      1,
+                                                      0,
+                                                      cvx::feature_flag::area,
+                                                      engine);
+
+                assert(ccs == 1);
+                assert(components.size() == 1);
+                assert(components[0].size() == (height - 1) * width / 2 + width);
+                assert(image == expected);
+            }
+
+            // The parallel strips overflow as well
+            cvx::thread_pool pool(3);
+            std::vector<unsigned char> image = make_comb(width, height);
+            std::vector<unsigned char> expected(image);
+
+            auto ccs = cvx::label_connected_components(image.begin(),
+                                                       image.end(),
+                                                       width,
+                                                       height,
+                                                       connectivity,
+                                                       1,
+                                                       0,
+                                                       pool);
+
+            assert(ccs == 1);
+            assert(image == expected);
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    // Exactly 255 final components still fit
+    try {
+        const std::size_t columns = 16;
+        const std::size_t blobs_width = 3 * columns;
+        const std::vector<unsigned char> blobs = make_blobs(255, columns);
+        const std::size_t blobs_height = blobs.size() / blobs_width;
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::block, cvx::label_engine::run }) {
+                std::vector<unsigned char> image(blobs);
+
+                assert(cvx::label_connected_components(image.begin(),
+                                                       image.end(),
+                                                       blobs_width,
+                                                       blobs_height,
+                                                       connectivity,
+                                                       1,
+                                                       0,
+                                                       engine) == 255);
+                assert(*std::max_element(image.begin(), image.end()) == 255);
+
+                std::vector<unsigned char> labels(blobs.size());
+
+                assert(cvx::label_connected_components(blobs.begin(),
+                                                       blobs.end(),
+                                                       labels.begin(),
+                                                       labels.end(),
+                                                       blobs_width,
+                                                       blobs_height,
+                                                       connectivity,
+                                                       1,
+                                                       0,
+                                                       engine) == 255);
+                assert(labels == image);
+
+                std::vector<cvx::connected_component> components;
+                image = blobs;
+
+                assert(cvx::label_connected_components(image.begin(),
+                                                       image.end(),
+                                                       std::back_inserter(components),
+                                                       blobs_width,
+                                                       blobs_height,
+                                                       connectivity,
+                                                       1,
+                                                       0,
+                                                       cvx::feature_flag::area,
+                                                       engine) == 255);
+                assert(components.size() == 255);
+                assert(components.back().size() == 4);
+                assert(labels == image);
+            }
+
+            cvx::thread_pool pool(3);
+            std::vector<unsigned char> image(blobs);
+
+            assert(cvx::label_connected_components(image.begin(),
+                                                   image.end(),
+                                                   blobs_width,
+                                                   blobs_height,
+                                                   connectivity,
+                                                   1,
+                                                   0,
+                                                   pool) == 255);
+            assert(*std::max_element(image.begin(), image.end()) == 255);
+        }
+
+        // Contour tracing uses every label too, whether the foreground is
+        // the largest label or the first one
+        std::vector<unsigned char> expected(blobs);
+        cvx::label_connected_components(expected.begin(), expected.end(), blobs_width, blobs_height, 8, 1, 0);
+
+        std::vector<unsigned char> labels(blobs.size());
+        std::vector<cvx::connected_component> components;
+
+        assert(cvx::label_connected_components(blobs.begin(),
+                                               blobs.end(),
+                                               labels.begin(),
+                                               labels.end(),
+                                               std::back_inserter(components),
+                                               blobs_width,
+                                               blobs_height,
+                                               8,
+                                               1,
+                                               0,
+                                               cvx::feature_flag::outer_contours) == 255);
+        assert(components.size() == 255);
+        assert(labels == expected);
+
+        for (unsigned char foreground : { 1, 255 }) {
+            std::vector<unsigned char> image(blobs);
+            std::replace(image.begin(), image.end(), static_cast<unsigned char>(1), foreground);
+            components.clear();
+
+            assert(cvx::label_connected_components(image.begin(),
+                                                   image.end(),
+                                                   std::back_inserter(components),
+                                                   blobs_width,
+                                                   blobs_height,
+                                                   8,
+                                                   foreground,
+                                                   0,
+                                                   cvx::feature_flag::outer_contours) == 255);
+            assert(components.size() == 255);
+            assert(image == expected);
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    // More than 255 final components cannot be represented
+    std::vector<unsigned char> teeth(width, 0);
+
+    for (std::size_t x = 0; x < width; x += 2) {
+        teeth[x] = 1;
+    }
+
+    bool thrown = false;
+
+    try {
+        cvx::label_connected_components(teeth.begin(), teeth.end(), width, 1, 4, 1, 0);
+    } catch (cvx::exception&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Compile statistics collection into this test regardless of the build option
+#define CVX_COLLECT_STATS
+
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+    const std::size_t width = 67;
+    const std::size_t height = 53;
+    std::mt19937 rng(11);
+    std::bernoulli_distribution dist(0.5);
+    std::vector<int> image(width * height);
+    std::vector<int> labels(image.size());
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    cvx::array_view<std::vector<int>::iterator> input(image.begin(), image.end(), width, height);
+    cvx::array_view<std::vector<int>::iterator> output(labels.begin(), labels.end(), width, height);
+
+    try {
+        for (cvx::label_engine engine : { cvx::label_engine::pixel, cvx::label_engine::block, cvx::label_engine::run }) {
+            for (cvx::feature_flag flags : { cvx::feature_flag::none, cvx::feature_flag::area | cvx::feature_flag::points }) {
+                cvx::labeler<int> labeler(8, flags, engine);
+                cvx::label_stats stats;
+
+                // Nothing is recorded without attached statistics
+                labeler.label(input, output, 1, 0);
+                assert(stats.components == 0);
+
+                labeler.set_stats(&stats);
+                const std::size_t count = labeler.label(input, output, 1, 0);
+
+                assert(stats.components == count);
+                assert(stats.provisional_labels >= count);
+                assert(stats.merges > 0);
+                assert(stats.peak_scratch_bytes > 0);
+                assert(stats.scan_ms >= 0.0 && stats.flatten_ms >= 0.0);
+                assert(stats.relabel_ms >= 0.0 && stats.finalise_ms >= 0.0);
+
+                // Each labelling overwrites the statistics of the last one
+                const std::size_t merges = stats.merges;
+                labeler.label(input, output, 1, 0);
+                assert(stats.merges == merges);
+                assert(stats.components == count);
+
+                labeler.set_stats(nullptr);
+                stats.reset();
+                labeler.label(input, output, 1, 0);
+                assert(stats.components == 0);
+            }
+        }
+
+        // A single row of isolated elements needs no merges
+        int row[] = { 1, 0, 1, 0, 1, 0, 1 };
+        cvx::array_view<int*> row_view(std::begin(row), std::end(row), 7, 1);
+        cvx::labeler<int> labeler(4);
+        cvx::label_stats stats;
+
+        labeler.set_stats(&stats);
+        assert(labeler.label(row_view, 1, 0) == 4);
+        assert(stats.provisional_labels == 4);
+        assert(stats.merges == 0);
+        assert(stats.compression_steps == 0);
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <vector>
+
+// Count all heap allocations of the test
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+std::vector<int> make_image(std::size_t width, std::size_t height, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(0.45);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    return image;
+}
+
+int main() {
+    const std::size_t width = 64;
+    const std::size_t height = 48;
+    const auto flags = cvx::feature_flag::area | cvx::feature_flag::centroid | cvx::feature_flag::bounding_box;
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::block }) {
+                cvx::labeler<int> labeler(connectivity, flags, engine);
+                std::vector<int> frame = make_image(width, height, 3);
+                std::vector<int> labels(width * height);
+
+                const cvx::array_view<std::vector<int>::const_iterator> input(frame.cbegin(), frame.cend(), width, height);
+                cvx::array_view<std::vector<int>::iterator> output(labels.begin(), labels.end(), width, height);
+
+                // The first frame grows the scratch memory
+                labeler.label(input, output, 1, 0);
+
+                // Later frames of the same size and complexity reuse it
+                for (int repeat = 0; repeat < 3; ++repeat) {
+                    allocations = 0;
+                    const std::size_t ccs = labeler.label(input, output, 1, 0);
+                    assert(allocations == 0);
+
+                    // Compare with the free function
+                    std::vector<int> expected_labels(frame);
+                    std::vector<cvx::connected_component> expected;
+                    cvx::label_connected_components(expected_labels.begin(),
+                                                    expected_labels.end(),
+                                                    std::back_inserter(expected),
+                                                    width,
+                                                    height,
+                                                    connectivity,
+                                                    1,
+                                                    0,
+                                                    flags,
+                                                    engine);
+
+                    assert(ccs == expected.size());
+                    assert(labels == expected_labels);
+                    assert(labeler.components().size() == expected.size());
+
+                    for (std::size_t i = 0; i < expected.size(); ++i) {
+                        const auto& cc = labeler.components()[i];
+                        assert(cc.label() == expected[i].label());
+                        assert(cc.size() == expected[i].size());
+                        assert(std::abs(cc.centroid().x - expected[i].centroid().x) < 1e-3f);
+                        assert(std::abs(cc.centroid().y - expected[i].centroid().y) < 1e-3f);
+                        assert(cc.bounding_box() == expected[i].bounding_box());
+                    }
+                }
+
+                // In place without features
+                cvx::labeler<int> plain(connectivity, cvx::feature_flag::none, engine);
+                std::vector<int> image = make_image(width, height, 5);
+                cvx::array_view<std::vector<int>::iterator> view(image.begin(), image.end(), width, height);
+                plain.label(view, 1, 0);
+
+                const std::vector<int> original = make_image(width, height, 5);
+                std::copy(original.begin(), original.end(), image.begin());
+                allocations = 0;
+                const std::size_t ccs = plain.label(view, 1, 0);
+                assert(allocations == 0);
+                assert(plain.components().empty());
+
+                std::vector<int> expected(original);
+                assert(ccs == cvx::label_connected_components(expected.begin(),
+                                                              expected.end(),
+                                                              width,
+                                                              height,
+                                                              connectivity,
+                                                              1,
+                                                              0,
+                                                              engine));
+                assert(image == expected);
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+void write_file(const std::string& path, const std::string& header, const std::vector<std::uint8_t>& data) {
+    std::ofstream out(path, std::ios::binary);
+    out << header;
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+template<typename Function>
+bool throws(Function f) {
+    try {
+        f();
+    } catch (cvx::exception&) {
+        return true;
+    }
+
+    return false;
+}
+
+int main() {
+    const std::string path = "test_mapped_image_file";
+    const std::size_t width = 45;
+    const std::size_t height = 31;
+    std::mt19937 rng(22);
+    std::bernoulli_distribution dist(0.5);
+    std::vector<std::uint8_t> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 255 : 0;
+    }
+
+    std::vector<int> expected(image.size());
+    const std::size_t expected_count = cvx::label_connected_components(image.begin(),
+                                                                       image.end(),
+                                                                       expected.begin(),
+                                                                       expected.end(),
+                                                                       width,
+                                                                       height,
+                                                                       8,
+                                                                       255,
+                                                                       0);
+
+    try {
+        std::vector<int> labels(image.size());
+        cvx::array_view<std::vector<int>::iterator> output(labels.begin(), labels.end(), width, height);
+        cvx::labeler<int> labeler(8);
+
+        // PGM with a comment in the header
+        {
+            write_file(path, "P5\n# comment\n45 31 255\n", image);
+            const cvx::mapped_image pgm(path);
+
+            assert(pgm.format() == cvx::image_format::pgm);
+            assert(pgm.width() == width && pgm.height() == height);
+            assert(pgm.stride() == width);
+            assert(pgm.maxval() == 255);
+            assert(std::equal(image.begin(), image.end(), pgm.data()));
+            assert(pgm.row(3) == pgm.data() + 3 * width);
+            assert(throws([&]() { pgm.row(height); }));
+            assert(throws([&]() { pgm.bits(); }));
+
+            assert(labeler.label(pgm.view(), output, 255, 0) == expected_count);
+            assert(labels == expected);
+        }
+
+        // PBM with padded rows
+        {
+            const std::size_t stride = (width + 7) / 8;
+            std::vector<std::uint8_t> packed(stride * height, 0);
+
+            for (std::size_t y = 0; y < height; ++y) {
+                for (std::size_t x = 0; x < width; ++x) {
+                    if (image[y * width + x]) {
+                        packed[y * stride + x / 8] |= static_cast<std::uint8_t>(0x80 >> (x % 8));
+                    }
+                }
+            }
+
+            write_file(path, "P4\n45 31\n", packed);
+            const cvx::mapped_image pbm(path);
+
+            assert(pbm.format() == cvx::image_format::pbm);
+            assert(pbm.stride() == stride);
+            assert(pbm.maxval() == 1);
+            assert(throws([&]() { pbm.view(); }));
+
+            std::fill(labels.begin(), labels.end(), 0);
+            assert(labeler.label(pbm.bits(), output, true, false) == expected_count);
+            assert(labels == expected);
+        }
+
+        // Raw pixels after a custom header, with and without padded rows
+        {
+            write_file(path, "HEAD", image);
+            const cvx::mapped_image raw(path, width, height, 0, 4, cvx::access_hint::random);
+
+            assert(raw.format() == cvx::image_format::raw);
+            assert(raw.stride() == width);
+            assert(std::equal(image.begin(), image.end(), raw.view().cbegin()));
+
+            std::vector<std::uint8_t> padded;
+
+            for (std::size_t y = 0; y < height; ++y) {
+                padded.insert(padded.end(), image.begin() + y * width, image.begin() + (y + 1) * width);
+                padded.insert(padded.end(), 19, 7);
+            }
+
+            write_file(path, "", padded);
+            const cvx::mapped_image strided(path, width, height, width + 19);
+
+            assert(strided.stride() == width + 19);
+            assert(strided.row(2)[0] == image[2 * width]);
+            assert(strided.view().stride() == width + 19);
+            assert(strided.view()(2, 0) == image[2 * width]);
+
+            std::fill(labels.begin(), labels.end(), 0);
+            assert(labeler.label(strided.view(), output, 255, 0) == expected_count);
+            assert(labels == expected);
+        }
+
+        // Truncated and malformed files
+        write_file(path, "P5 45 31 255\n", std::vector<std::uint8_t>(100));
+        assert(throws([&]() { cvx::mapped_image truncated(path); }));
+
+        write_file(path, "P6 45 31 255\n", image);
+        assert(throws([&]() { cvx::mapped_image color(path); }));
+
+        write_file(path, "P5 45\n", image);
+        assert(throws([&]() { cvx::mapped_image malformed(path); }));
+
+        // Sizes whose product or sum wraps around must not map nothing
+        write_file(path, "P5\n4294967296 4294967296\n255\n", std::vector<std::uint8_t>());
+        assert(throws([&]() { cvx::mapped_image huge(path); }));
+
+        write_file(path, "P5\n99999999999999999999999 1\n255\n", std::vector<std::uint8_t>());
+        assert(throws([&]() { cvx::mapped_image huge(path); }));
+
+        write_file(path, "HEAD", image);
+        assert(throws([&]() { cvx::mapped_image huge(path, std::size_t(1) << 32, (std::size_t(1) << 32) + 1); }));
+        assert(throws([&]() { cvx::mapped_image huge(path, width, height, 0, static_cast<std::size_t>(-1)); }));
+
+        assert(throws([&]() { cvx::mapped_image raw(path, width, height, width - 1); }));
+        assert(throws([]() { cvx::mapped_image missing("test_mapped_image_missing"); }));
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::remove(path.c_str());
+
+    return 0;
+}
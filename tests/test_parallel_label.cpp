@@ -0,0 +1,76 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+int main() {
+    const int width = 97;
+    const int height = 131;
+    std::mt19937 rng(42);
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (double density : { 0.2, 0.5, 0.8 }) {
+                std::bernoulli_distribution dist(density);
+                std::vector<int> image(width * height);
+
+                for (auto& e : image) {
+                    e = dist(rng) ? 1 : 0;
+                }
+
+                std::vector<int> expected(image);
+                auto expected_count = cvx::label_connected_components(expected.begin(),
+                                                                      expected.end(),
+                                                                      width,
+                                                                      height,
+                                                                      connectivity,
+                                                                      1,
+                                                                      0);
+
+                for (std::size_t threads = 1; threads <= 7; threads += 2) {
+                    cvx::thread_pool pool(threads);
+                    assert(pool.size() == threads);
+
+                    std::vector<int> labelled(image);
+                    auto count = cvx::label_connected_components(labelled.begin(),
+                                                                 labelled.end(),
+                                                                 width,
+                                                                 height,
+                                                                 connectivity,
+                                                                 1,
+                                                                 0,
+                                                                 pool);
+
+                    assert(count == expected_count);
+                    assert(labelled == expected);
+                }
+            }
+        }
+
+        // More threads than rows
+        int input[][4] = { {1, 0, 1, 1},
+                           {1, 1, 0, 1},
+                           {0, 0, 0, 1} };
+
+        cvx::thread_pool pool(8);
+        auto ccs = cvx::label_connected_components(std::begin(input[0]),
+                                                   std::end(input[2]),
+                                                   4,
+                                                   3,
+                                                   4,
+                                                   1,
+                                                   0,
+                                                   pool);
+
+        assert(ccs == 2);
+        assert(input[2][3] == 2);
+        assert(input[1][1] == 1);
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <cvx.hpp>
 #include <algorithm>
 #include <assert.h>
+#include <iostream>
 #include <iterator>
 #include <type_traits>
 
@@ -0,0 +1,134 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+
+void test_runs() {
+    cvx::point_runs runs;
+    assert(runs.empty());
+    assert(runs.begin() == runs.end());
+    assert(!runs.contains(cvx::point2i(0, 0)));
+
+    // Consecutive points and runs on the same row merge into one run
+    runs.add(2, 0);
+    runs.add(3, 0);
+    runs.add_run(0, 4, 6);
+    runs.add(8, 0);
+    runs.add_run(1, 0, 3);
+    runs.add(1, 2);
+
+    assert(runs.size() == 9);
+    assert(runs.runs().size() == 4);
+    assert(runs.runs()[0] == (cvx::point_run{ 0, 2, 6 }));
+    assert(runs.runs()[1] == (cvx::point_run{ 0, 8, 9 }));
+    assert(runs.runs()[2] == (cvx::point_run{ 1, 0, 3 }));
+    assert(runs.runs()[3] == (cvx::point_run{ 2, 1, 2 }));
+
+    const std::vector<cvx::point2i> expected = { { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 8, 0 },
+                                                 { 0, 1 }, { 1, 1 }, { 2, 1 }, { 1, 2 } };
+    const std::vector<cvx::point2i> points(runs.begin(), runs.end());
+    assert(points == expected);
+
+    for (int y = -1; y < 4; ++y) {
+        for (int x = -1; x < 10; ++x) {
+            const cvx::point2i p(x, y);
+            assert(runs.contains(p) == (std::find(expected.begin(), expected.end(), p) != expected.end()));
+        }
+    }
+
+    assert(runs.bounding_box() == cvx::rectangle2i(0, 0, 9, 3));
+
+    runs.clear();
+    assert(runs.empty());
+    assert(runs.runs().empty());
+}
+
+void test_components(unsigned char connectivity, cvx::label_engine engine) {
+    const std::size_t width = 61;
+    const std::size_t height = 47;
+    std::mt19937 rng(connectivity);
+    std::bernoulli_distribution dist(0.6);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    std::vector<cvx::connected_component> components;
+    std::vector<int> labels(image);
+    cvx::label_connected_components(labels.begin(),
+                                    labels.end(),
+                                    std::back_inserter(components),
+                                    width,
+                                    height,
+                                    connectivity,
+                                    1,
+                                    0,
+                                    cvx::feature_flag::points,
+                                    engine);
+
+    std::size_t total = 0;
+
+    for (const auto& component : components) {
+        const cvx::point_runs& runs = component.runs();
+
+        assert(runs.size() == component.area());
+        assert(runs.runs().size() <= component.area());
+        total += runs.size();
+
+        // Runs are maximal, in raster order and expand to points()
+        for (std::size_t i = 1; i < runs.runs().size(); ++i) {
+            const cvx::point_run& a = runs.runs()[i - 1];
+            const cvx::point_run& b = runs.runs()[i];
+            assert(a.y < b.y || (a.y == b.y && a.x_end < b.x_begin));
+        }
+
+        assert(std::vector<cvx::point2i>(runs.begin(), runs.end()) == component.points());
+
+        // The inferred bounding box matches the points
+        int min_x = std::numeric_limits<int>::max();
+        int max_x = -1;
+
+        for (const auto& p : component.points()) {
+            min_x = std::min(min_x, p.x);
+            max_x = std::max(max_x, p.x);
+        }
+
+        const int min_y = component.points().front().y;
+        const int max_y = component.points().back().y;
+        assert(component.bounding_box() == cvx::rectangle2i(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1));
+    }
+
+    assert(total == static_cast<std::size_t>(std::count(image.begin(), image.end(), 1)));
+
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            const int label = labels[y * width + x];
+            const cvx::point2i p(static_cast<int>(x), static_cast<int>(y));
+
+            for (const auto& component : components) {
+                assert(component.contains(p) == (static_cast<int>(component.label()) == label));
+            }
+        }
+    }
+}
+
+int main() {
+    try {
+        test_runs();
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            test_components(connectivity, cvx::label_engine::pixel);
+            test_components(connectivity, cvx::label_engine::run);
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
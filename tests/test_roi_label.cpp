@@ -0,0 +1,276 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// A frame of random noise whose rows are padded to the stride. The padding
+// is foreground, so it changes the labels if it is ever read
+std::vector<int> make_padded_noise(std::size_t width, std::size_t height, std::size_t stride, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(0.45);
+    std::vector<int> frame(stride * height, 1);
+
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            frame[y * stride + x] = dist(rng) ? 1 : 0;
+        }
+    }
+
+    return frame;
+}
+
+// Copy the elements of a view into a contiguous image
+std::vector<int> copy_view(const cvx::array_view<std::vector<int>::iterator>& view) {
+    std::vector<int> image;
+
+    for (std::size_t y = 0; y < view.height(); ++y) {
+        image.insert(image.end(), view.cbegin() + y * view.stride(), view.cbegin() + y * view.stride() + view.width());
+    }
+
+    return image;
+}
+
+bool same_components(const std::vector<cvx::connected_component>& a, const std::vector<cvx::connected_component>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].area() != b[i].area() || !(a[i].bounding_box() == b[i].bounding_box())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main() {
+    const std::size_t width = 57;
+    const std::size_t height = 43;
+    const std::size_t stride = 64;
+    const cvx::rectangle2i roi(5, 4, 30, 25);
+    const auto engines = { cvx::label_engine::pixel, cvx::label_engine::block, cvx::label_engine::run };
+
+    try {
+        std::vector<int> frame = make_padded_noise(width, height, stride, 23);
+        const cvx::array_view<std::vector<int>::iterator> padded(frame.begin(),
+                                                                 frame.begin() + stride * (height - 1) + width,
+                                                                 width,
+                                                                 height,
+                                                                 stride);
+
+        assert(padded.stride() == stride);
+        assert(padded.pitch() == stride * sizeof(int));
+        assert(!padded.contiguous());
+        assert(padded(3, 7) == frame[3 * stride + 7]);
+
+        const auto region = padded.subview(roi);
+
+        assert(region.width() == 30 && region.height() == 25);
+        assert(region.stride() == stride);
+        assert(region(0, 0) == frame[4 * stride + 5]);
+        assert(region(24, 29) == frame[28 * stride + 34]);
+        assert(region.cend() == region.cbegin() + 24 * stride + 30);
+        assert(region.subview(cvx::rectangle2i(1, 2, 3, 4))(0, 0) == frame[6 * stride + 6]);
+
+        bool thrown = false;
+
+        try {
+            padded.subview(cvx::rectangle2i(50, 0, 8, 1));
+        } catch (cvx::exception&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : engines) {
+                // 1. The whole padded frame and a region of it, into padded
+                //    label buffers whose padding must not be written
+                for (bool whole : { true, false }) {
+                    const auto input = (whole ? padded : region);
+                    std::vector<int> expected = copy_view(input);
+                    std::vector<cvx::connected_component> expected_components;
+                    const std::size_t expected_count = cvx::label_connected_components(expected.begin(),
+                                                                                       expected.end(),
+                                                                                       std::back_inserter(expected_components),
+                                                                                       input.width(),
+                                                                                       input.height(),
+                                                                                       connectivity,
+                                                                                       1,
+                                                                                       0,
+                                                                                       cvx::feature_flag::area |
+                                                                                       cvx::feature_flag::bounding_box);
+
+                    std::vector<int> labels(stride * height, -7);
+                    cvx::array_view<std::vector<int>::iterator> all_labels(labels.begin(),
+                                                                           labels.begin() + stride * (height - 1) + width,
+                                                                           width,
+                                                                           height,
+                                                                           stride);
+                    auto output = (whole ? all_labels : all_labels.subview(roi));
+
+                    assert(cvx::label_connected_components(input, output, connectivity, 1, 0, engine) == expected_count);
+                    assert(copy_view(output) == expected);
+
+                    std::vector<cvx::connected_component> components;
+                    std::fill(labels.begin(), labels.end(), -7);
+
+                    assert(cvx::label_connected_components(input,
+                                                           output,
+                                                           std::back_inserter(components),
+                                                           connectivity,
+                                                           1,
+                                                           0,
+                                                           cvx::feature_flag::area | cvx::feature_flag::bounding_box,
+                                                           engine) == expected_count);
+                    assert(copy_view(output) == expected);
+                    assert(same_components(components, expected_components));
+                    assert(std::count(labels.begin(), labels.end(), -7) ==
+                           static_cast<std::ptrdiff_t>(labels.size() - output.size()));
+
+                    // 2. In place, leaving everything outside the view as is
+                    std::vector<int> image(frame);
+                    cvx::array_view<std::vector<int>::iterator> view(image.begin(),
+                                                                     image.begin() + stride * (height - 1) + width,
+                                                                     width,
+                                                                     height,
+                                                                     stride);
+                    auto target = (whole ? view : view.subview(roi));
+
+                    assert(cvx::label_connected_components(target, connectivity, 1, 0, engine) == expected_count);
+                    assert(copy_view(target) == expected);
+
+                    for (std::size_t i = 0; i < image.size(); ++i) {
+                        const std::size_t y = i / stride;
+                        const std::size_t x = i % stride;
+                        const bool inside = (whole ? x < width :
+                                             (x >= 5 && x < 35 && y >= 4 && y < 29));
+
+                        assert(inside || image[i] == frame[i]);
+                    }
+                }
+            }
+
+            // 3. Contour tracing on a region, which only follows 8-connectivity
+            std::vector<int> expected = copy_view(region);
+            const std::size_t expected_count = cvx::label_connected_components(expected.begin(),
+                                                                               expected.end(),
+                                                                               region.width(),
+                                                                               region.height(),
+                                                                               connectivity,
+                                                                               1,
+                                                                               0);
+            std::vector<int> labels(stride * height, -7);
+            cvx::array_view<std::vector<int>::iterator> all_labels(labels.begin(),
+                                                                   labels.begin() + stride * (height - 1) + width,
+                                                                   width,
+                                                                   height,
+                                                                   stride);
+            auto output = all_labels.subview(roi);
+
+            if (connectivity == 8) {
+                std::vector<cvx::connected_component> components;
+
+                assert(cvx::label_connected_components(region,
+                                                       output,
+                                                       std::back_inserter(components),
+                                                       connectivity,
+                                                       1,
+                                                       0,
+                                                       cvx::feature_flag::outer_contours) == expected_count);
+                assert(components.size() == expected_count);
+                assert(std::count(labels.begin(), labels.end(), -7) ==
+                       static_cast<std::ptrdiff_t>(labels.size() - output.size()));
+            }
+
+            // 4. Parallel strips of a region
+            cvx::thread_pool pool(3);
+            std::fill(labels.begin(), labels.end(), -7);
+
+            assert(cvx::detail::parallel_two_pass_label(region, output, connectivity, 0, pool) == expected_count);
+            assert(copy_view(output) == expected);
+            assert(std::count(labels.begin(), labels.end(), -7) ==
+                   static_cast<std::ptrdiff_t>(labels.size() - output.size()));
+        }
+
+        // 5. Provisional labels that overflow in a padded region fall back
+        //    to a wider label type
+        {
+            const std::size_t comb_width = 700;
+            const std::size_t comb_height = 4;
+            const std::size_t comb_stride = comb_width + 10;
+            std::vector<unsigned char> image((comb_height + 2) * comb_stride, 1);
+            cvx::array_view<std::vector<unsigned char>::iterator> view(image.begin(),
+                                                                       image.end(),
+                                                                       comb_stride,
+                                                                       comb_height + 2);
+
+            for (std::size_t y = 1; y <= comb_height; ++y) {
+                for (std::size_t x = 3; x < 3 + comb_width; ++x) {
+                    image[y * comb_stride + x] = (y == comb_height || (x - 3) % 2 == 0) ? 1 : 0;
+                }
+            }
+
+            const std::vector<unsigned char> comb(image);
+            auto teeth = view.subview(cvx::rectangle2i(3, 1, comb_width, comb_height));
+
+            for (auto engine : engines) {
+                image = comb;
+
+                assert(cvx::label_connected_components(teeth, 4, 1, 0, engine) == 1);
+                assert(image == comb);
+            }
+        }
+
+        // 6. A region of a packed binary image, whose rows do not start on a
+        //    byte boundary
+        {
+            const std::size_t bytes_per_row = (width + 7) / 8;
+            std::vector<std::uint8_t> packed(bytes_per_row * height, 0);
+
+            for (std::size_t y = 0; y < height; ++y) {
+                for (std::size_t x = 0; x < width; ++x) {
+                    if (frame[y * stride + x]) {
+                        packed[y * bytes_per_row + x / 8] |= static_cast<std::uint8_t>(0x80 >> (x % 8));
+                    }
+                }
+            }
+
+            const cvx::bit_view bits = cvx::make_bit_view(packed.data(), width, height, 0, cvx::bit_order::msb_first);
+            const auto bit_region = bits.subview(roi);
+
+            for (unsigned char connectivity : { 4, 8 }) {
+                std::vector<int> expected = copy_view(region);
+                const std::size_t expected_count = cvx::label_connected_components(expected.begin(),
+                                                                                   expected.end(),
+                                                                                   region.width(),
+                                                                                   region.height(),
+                                                                                   connectivity,
+                                                                                   1,
+                                                                                   0);
+
+                for (auto engine : engines) {
+                    std::vector<int> labels(region.size());
+                    cvx::array_view<std::vector<int>::iterator> output(labels.begin(),
+                                                                       labels.end(),
+                                                                       region.width(),
+                                                                       region.height());
+
+                    assert(cvx::label_connected_components(bit_region, output, connectivity, true, false, engine) ==
+                           expected_count);
+                    assert(labels == expected);
+                }
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Random horizontal strokes, the kind of image the run engine is made for
+std::vector<int> make_strokes(std::size_t width, std::size_t height, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> length(1, width / 3);
+    std::uniform_int_distribution<std::size_t> position(0, width - 1);
+    std::vector<int> image(width * height, 0);
+
+    for (std::size_t y = 0; y < height; ++y) {
+        for (int stroke = 0; stroke < 3; ++stroke) {
+            const std::size_t start = position(rng);
+            const std::size_t end = std::min(width, start + length(rng));
+
+            for (std::size_t x = start; x < end; ++x) {
+                image[y * width + x] = 1;
+            }
+        }
+    }
+
+    return image;
+}
+
+std::vector<int> make_noise(std::size_t width, std::size_t height, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(0.5);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    return image;
+}
+
+void check(const std::vector<int>& image, std::size_t width, std::size_t height, unsigned char connectivity) {
+    const auto flags = cvx::feature_flag::area | cvx::feature_flag::centroid | cvx::feature_flag::points;
+
+    std::vector<int> expected_labels(image);
+    std::vector<cvx::connected_component> expected;
+    auto expected_count = cvx::label_connected_components(expected_labels.begin(),
+                                                          expected_labels.end(),
+                                                          std::back_inserter(expected),
+                                                          width,
+                                                          height,
+                                                          connectivity,
+                                                          1,
+                                                          0,
+                                                          flags,
+                                                          cvx::label_engine::pixel);
+
+    // Without features, in place
+    std::vector<int> labels(image);
+    auto ccs = cvx::label_connected_components(labels.begin(),
+                                               labels.end(),
+                                               width,
+                                               height,
+                                               connectivity,
+                                               1,
+                                               0,
+                                               cvx::label_engine::run);
+
+    assert(ccs == expected_count);
+    assert(labels == expected_labels);
+
+    // With features, into a separate label image
+    std::vector<int> separate(width * height, -1);
+    std::vector<cvx::connected_component> components;
+    ccs = cvx::label_connected_components(image.cbegin(),
+                                          image.cend(),
+                                          separate.begin(),
+                                          separate.end(),
+                                          std::back_inserter(components),
+                                          width,
+                                          height,
+                                          connectivity,
+                                          1,
+                                          0,
+                                          flags,
+                                          cvx::label_engine::run);
+
+    assert(ccs == expected_count);
+    assert(separate == expected_labels);
+    assert(components.size() == expected.size());
+
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        assert(components[i].size() == expected[i].size());
+        assert(components[i].points() == expected[i].points());
+        assert(std::abs(components[i].centroid().x - expected[i].centroid().x) < 1e-3f);
+        assert(std::abs(components[i].centroid().y - expected[i].centroid().y) < 1e-3f);
+    }
+}
+
+int main() {
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (unsigned int seed = 0; seed < 4; ++seed) {
+                check(make_strokes(97, 61, seed), 97, 61, connectivity);
+                check(make_noise(53, 41, seed), 53, 41, connectivity);
+            }
+
+            // Single rows and columns
+            check(make_noise(64, 1, 9), 64, 1, connectivity);
+            check(make_noise(1, 64, 9), 1, 64, connectivity);
+        }
+
+        // Too many runs for the label type fall back to a wider type
+        const std::size_t width = 700;
+        std::vector<unsigned char> comb(width * 2, 0);
+
+        for (std::size_t x = 0; x < width; ++x) {
+            comb[x] = (x % 2 == 0);
+            comb[width + x] = 1;
+        }
+
+        auto ccs = cvx::label_connected_components(comb.begin(),
+                                                   comb.end(),
+                                                   width,
+                                                   2,
+                                                   4,
+                                                   1,
+                                                   0,
+                                                   cvx::label_engine::run);
+
+        assert(ccs == 1);
+        assert(std::count(comb.begin(), comb.end(), 1) == static_cast<std::ptrdiff_t>(width + width / 2));
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
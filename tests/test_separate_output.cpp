@@ -0,0 +1,138 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+int main() {
+    const int width = 83;
+    const int height = 61;
+    std::mt19937 rng(3);
+    std::bernoulli_distribution dist(0.45);
+
+    // A packed 8-bit mask that must not be modified
+    std::vector<std::uint8_t> mask(width * height);
+
+    for (auto& e : mask) {
+        e = dist(rng) ? 255 : 0;
+    }
+
+    const std::vector<std::uint8_t> original(mask);
+    const std::vector<std::uint8_t>& input = mask;
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::block }) {
+                // Reference: label an int copy of the mask in place
+                std::vector<int> expected(input.begin(), input.end());
+                auto expected_count = cvx::label_connected_components(expected.begin(),
+                                                                      expected.end(),
+                                                                      width,
+                                                                      height,
+                                                                      connectivity,
+                                                                      255,
+                                                                      0,
+                                                                      engine);
+
+                std::vector<int> labels(width * height, -1);
+                auto count = cvx::label_connected_components(input.begin(),
+                                                             input.end(),
+                                                             labels.begin(),
+                                                             labels.end(),
+                                                             width,
+                                                             height,
+                                                             connectivity,
+                                                             255,
+                                                             0,
+                                                             engine);
+
+                assert(count == expected_count);
+                assert(labels == expected);
+                assert(mask == original);
+
+                // A narrower label type and feature extraction
+                std::vector<std::uint16_t> short_labels(width * height);
+                std::vector<cvx::connected_component> components;
+                count = cvx::label_connected_components(input.begin(),
+                                                        input.end(),
+                                                        short_labels.begin(),
+                                                        short_labels.end(),
+                                                        std::back_inserter(components),
+                                                        width,
+                                                        height,
+                                                        connectivity,
+                                                        255,
+                                                        0,
+                                                        cvx::feature_flag::area,
+                                                        engine);
+
+                assert(count == expected_count);
+                assert(components.size() == count);
+                assert(std::equal(short_labels.begin(), short_labels.end(), expected.begin()));
+                assert(mask == original);
+
+                std::size_t area = 0;
+
+                for (auto& cc : components) {
+                    area += cc.size();
+                }
+
+                assert(area == width * height - static_cast<std::size_t>(std::count(input.begin(), input.end(), 0)));
+            }
+
+            // Multiple threads
+            cvx::thread_pool pool(4);
+            std::vector<int> expected(input.begin(), input.end());
+            cvx::label_connected_components(expected.begin(),
+                                            expected.end(),
+                                            width,
+                                            height,
+                                            connectivity,
+                                            255,
+                                            0);
+
+            std::vector<int> labels(width * height);
+            cvx::label_connected_components(input.begin(),
+                                            input.end(),
+                                            labels.begin(),
+                                            labels.end(),
+                                            width,
+                                            height,
+                                            connectivity,
+                                            255,
+                                            0,
+                                            pool);
+
+            assert(labels == expected);
+            assert(mask == original);
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    // The label image must match the image data
+    std::vector<int> small(width);
+    bool thrown = false;
+
+    try {
+        cvx::label_connected_components(input.begin(),
+                                        input.end(),
+                                        small.begin(),
+                                        small.end(),
+                                        width,
+                                        height,
+                                        4,
+                                        255,
+                                        0);
+    } catch (cvx::exception&) {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <cvx.hpp>
+#include <cvx/detail/simd.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template<typename T>
+void check_find(std::mt19937& rng) {
+    std::vector<T> row(300, T(7));
+    std::uniform_int_distribution<std::size_t> position(0, row.size() - 1);
+
+    for (int i = 0; i < 200; ++i) {
+        std::fill(row.begin(), row.end(), T(7));
+        const std::size_t hit = position(rng);
+        const std::size_t first = position(rng);
+        row[hit] = T(-1);
+
+        // Every alignment and every offset into the vector lanes
+        const std::size_t expected = (hit >= first ? hit : row.size());
+        assert(cvx::detail::find_foreground(row.cbegin(), first, row.size(), T(7)) == expected);
+        assert(cvx::detail::find_foreground(row.data(), first, row.size(), T(7)) == expected);
+
+        std::fill(row.begin(), row.end(), T(-1));
+        row[hit] = T(7);
+        assert(cvx::detail::find_background(row.cbegin(), first, row.size(), T(7)) == expected);
+    }
+
+    // Nothing to find
+    std::fill(row.begin(), row.end(), T(0));
+    assert(cvx::detail::find_foreground(row.cbegin(), 0, row.size(), T(0)) == row.size());
+    assert(cvx::detail::find_background(row.cbegin(), 5, 5, T(0)) == 5);
+}
+
+template<typename T>
+void check_lookup(std::mt19937& rng) {
+    std::vector<T> table(1000);
+    std::uniform_int_distribution<std::size_t> label(0, table.size() - 1);
+
+    for (std::size_t i = 1; i < table.size(); ++i) {
+        table[i] = static_cast<T>(label(rng));
+    }
+
+    // Every length and every offset into the vector lanes, leaving the
+    // labels around the span untouched
+    for (std::size_t first = 0; first < 9; ++first) {
+        for (std::size_t count = 0; count < 40; ++count) {
+            std::vector<T> labels(first + count + 3);
+
+            for (auto& e : labels) {
+                e = static_cast<T>(label(rng) % 3 ? label(rng) : 0);
+            }
+
+            std::vector<T> expected(labels);
+
+            for (std::size_t i = first; i < first + count; ++i) {
+                expected[i] = table[expected[i]];
+            }
+
+            const std::vector<T> original(labels);
+            cvx::detail::relabel_span(labels.begin() + first, count, table.data(), table.size());
+            assert(labels == expected);
+
+            std::deque<T> slow(original.begin(), original.end());
+            cvx::detail::relabel_span(slow.begin() + first, count, table.data(), table.size());
+            assert(std::equal(slow.begin(), slow.end(), expected.begin()));
+        }
+    }
+}
+
+int main() {
+    std::cout << "SIMD kernel: " << cvx::detail::simd_kernel_name() << std::endl;
+
+    static_assert(cvx::detail::is_simd_searchable<std::vector<unsigned char>::const_iterator>::value, "");
+    static_assert(cvx::detail::is_simd_searchable<const short*>::value, "");
+    static_assert(!cvx::detail::is_simd_searchable<std::deque<int>::iterator>::value, "");
+    static_assert(!cvx::detail::is_simd_searchable<std::vector<float>::iterator>::value, "");
+    static_assert(cvx::detail::is_simd_gatherable<int*>::value, "");
+    static_assert(cvx::detail::is_simd_gatherable<std::vector<std::uint64_t>::iterator>::value, "");
+    static_assert(!cvx::detail::is_simd_gatherable<std::vector<unsigned short>::iterator>::value, "");
+    static_assert(!cvx::detail::is_simd_gatherable<std::deque<int>::iterator>::value, "");
+
+    std::mt19937 rng(5);
+    check_find<std::uint8_t>(rng);
+    check_find<std::int16_t>(rng);
+    check_find<int>(rng);
+    check_find<std::int64_t>(rng);
+    check_lookup<std::uint16_t>(rng);
+    check_lookup<int>(rng);
+    check_lookup<std::uint32_t>(rng);
+    check_lookup<std::int64_t>(rng);
+
+    // Sparse masks are labelled the same with and without the kernels,
+    // since a std::deque is searched one element at a time
+    const std::size_t width = 97;
+    const std::size_t height = 41;
+    std::bernoulli_distribution dist(0.04);
+    std::vector<unsigned char> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (auto engine : { cvx::label_engine::pixel, cvx::label_engine::run }) {
+                std::deque<unsigned char> expected(image.begin(), image.end());
+                std::vector<unsigned char> labels(image);
+
+                auto expected_count = cvx::label_connected_components(expected.begin(),
+                                                                      expected.end(),
+                                                                      width,
+                                                                      height,
+                                                                      connectivity,
+                                                                      1,
+                                                                      0,
+                                                                      engine);
+
+                auto ccs = cvx::label_connected_components(labels.begin(),
+                                                           labels.end(),
+                                                           width,
+                                                           height,
+                                                           connectivity,
+                                                           1,
+                                                           0,
+                                                           engine);
+
+                assert(ccs == expected_count);
+                assert(std::equal(labels.begin(), labels.end(), expected.begin()));
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+bool same_features(const cvx::connected_component& a, const cvx::connected_component& b) {
+    return a.label() == b.label() &&
+           a.size() == b.size() &&
+           std::abs(a.centroid().x - b.centroid().x) < 1e-3f &&
+           std::abs(a.centroid().y - b.centroid().y) < 1e-3f &&
+           a.bounding_box() == b.bounding_box();
+}
+
+int main() {
+    const int width = 57;
+    const int height = 43;
+    std::mt19937 rng(11);
+    std::bernoulli_distribution dist(0.4);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            // Reference: The points extractor has no static policy, so this
+            // goes through the virtual extractors
+            std::vector<int> expected_labels(image);
+            std::vector<cvx::connected_component> expected;
+            cvx::label_connected_components(expected_labels.begin(),
+                                            expected_labels.end(),
+                                            std::back_inserter(expected),
+                                            width,
+                                            height,
+                                            connectivity,
+                                            1,
+                                            0,
+                                            cvx::feature_flag::area |
+                                            cvx::feature_flag::centroid |
+                                            cvx::feature_flag::bounding_box |
+                                            cvx::feature_flag::points);
+
+            std::vector<int> labels(image);
+            std::vector<cvx::connected_component> components;
+            auto ccs = cvx::label_connected_components<cvx::features<cvx::area, cvx::centroid, cvx::bounding_box>>(
+                labels.begin(),
+                labels.end(),
+                std::back_inserter(components),
+                width,
+                height,
+                connectivity,
+                1,
+                0);
+
+            assert(ccs == expected.size());
+            assert(labels == expected_labels);
+
+            for (std::size_t i = 0; i < components.size(); ++i) {
+                assert(same_features(components[i], expected[i]));
+            }
+
+            // The centroid pulls in the area it is normalised by
+            const std::vector<int>& input = image;
+            std::vector<unsigned short> short_labels(width * height);
+            components.clear();
+            ccs = cvx::label_connected_components<cvx::features<cvx::centroid>>(input.begin(),
+                                                                                 input.end(),
+                                                                                 short_labels.begin(),
+                                                                                 short_labels.end(),
+                                                                                 std::back_inserter(components),
+                                                                                 width,
+                                                                                 height,
+                                                                                 connectivity,
+                                                                                 1,
+                                                                                 0,
+                                                                                 cvx::label_engine::block);
+
+            assert(ccs == expected.size());
+
+            for (std::size_t i = 0; i < components.size(); ++i) {
+                assert(components[i].size() == expected[i].size());
+                assert(std::abs(components[i].centroid().x - expected[i].centroid().x) < 1e-3f);
+                assert(std::abs(components[i].centroid().y - expected[i].centroid().y) < 1e-3f);
+            }
+
+            // Runtime flags are dispatched to the precompiled static sets
+            labels = image;
+            components.clear();
+            ccs = cvx::label_connected_components(labels.begin(),
+                                                  labels.end(),
+                                                  std::back_inserter(components),
+                                                  width,
+                                                  height,
+                                                  connectivity,
+                                                  1,
+                                                  0,
+                                                  cvx::feature_flag::centroid | cvx::feature_flag::bounding_box);
+
+            assert(ccs == expected.size());
+
+            for (std::size_t i = 0; i < components.size(); ++i) {
+                assert(same_features(components[i], expected[i]));
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
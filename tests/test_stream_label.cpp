@@ -0,0 +1,158 @@
+#include <cvx.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using key = std::tuple<int, int, int, int, std::size_t>;
+
+key make_key(const cvx::connected_component& component) {
+    const cvx::rectangle2i box = component.bounding_box();
+    return key(box.y, box.x, box.width, box.height, component.area());
+}
+
+// Indices of the components in key order. Components are not copy
+// assignable without warnings, so they are sorted through their indices
+std::vector<std::size_t> sorted_indices(const std::vector<cvx::connected_component>& components) {
+    std::vector<std::size_t> indices(components.size());
+
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = i;
+    }
+
+    std::sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
+        return make_key(components[a]) < make_key(components[b]);
+    });
+
+    return indices;
+}
+
+bool same_centroid(const cvx::connected_component& a, const cvx::connected_component& b) {
+    return std::abs(a.centroid().x - b.centroid().x) < 1e-3f &&
+           std::abs(a.centroid().y - b.centroid().y) < 1e-3f;
+}
+
+void check(std::size_t width, std::size_t height, double density, unsigned char connectivity, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(density);
+    std::vector<int> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 1 : 0;
+    }
+
+    std::vector<int> labels(image.size());
+    std::vector<cvx::connected_component> expected;
+    cvx::label_connected_components(image.begin(),
+                                    image.end(),
+                                    labels.begin(),
+                                    labels.end(),
+                                    std::back_inserter(expected),
+                                    width,
+                                    height,
+                                    connectivity,
+                                    1,
+                                    0,
+                                    cvx::feature_flag::area | cvx::feature_flag::centroid | cvx::feature_flag::bounding_box);
+
+    cvx::stream_labeler labeler(width, connectivity);
+    std::vector<cvx::connected_component> streamed;
+
+    for (std::size_t y = 0; y < height; ++y) {
+        const auto row = image.begin() + y * width;
+        labeler.push_row(row, row + width, 0);
+        assert(labeler.rows() == y + 1);
+
+        // Components are finished on the first row that does not touch them
+        for (const auto& component : labeler.components()) {
+            const cvx::rectangle2i box = component.bounding_box();
+            assert(static_cast<std::size_t>(box.y + box.height) == y);
+            streamed.push_back(component);
+        }
+
+        // At most one live component per run of the row
+        assert(labeler.live_count() <= (width + 1) / 2);
+    }
+
+    labeler.finish();
+    assert(labeler.live_count() == 0);
+
+    for (const auto& component : labeler.components()) {
+        const cvx::rectangle2i box = component.bounding_box();
+        assert(static_cast<std::size_t>(box.y + box.height) == height);
+        streamed.push_back(component);
+    }
+
+    assert(labeler.label_count() == expected.size());
+    assert(streamed.size() == expected.size());
+
+    for (std::size_t i = 0; i < streamed.size(); ++i) {
+        assert(streamed[i].label() == i + 1);
+    }
+
+    // Same components, in a different order
+    const std::vector<std::size_t> streamed_order = sorted_indices(streamed);
+    const std::vector<std::size_t> expected_order = sorted_indices(expected);
+
+    for (std::size_t i = 0; i < streamed.size(); ++i) {
+        const cvx::connected_component& a = streamed[streamed_order[i]];
+        const cvx::connected_component& b = expected[expected_order[i]];
+
+        assert(make_key(a) == make_key(b));
+        assert(same_centroid(a, b));
+    }
+}
+
+int main() {
+    try {
+        for (unsigned char connectivity : { 4, 8 }) {
+            check(1, 50, 0.5, connectivity, 1);
+            check(50, 1, 0.5, connectivity, 2);
+            check(64, 48, 0.3, connectivity, 3);
+            check(64, 48, 0.6, connectivity, 4);
+            check(97, 131, 0.5, connectivity, 5);
+        }
+
+        // A U shape merges two live components on its last row, and the
+        // labeler keeps working after finish() and reset()
+        const int u[] = { 1, 0, 1,
+                          1, 0, 1,
+                          1, 1, 1 };
+
+        cvx::stream_labeler labeler(3, 4);
+
+        for (int pass = 0; pass < 2; ++pass) {
+            assert(labeler.push_row(u, u + 3, 0) == 0);
+            assert(labeler.live_count() == 2);
+            assert(labeler.push_row(u + 3, u + 6, 0) == 0);
+            assert(labeler.push_row(u + 6, u + 9, 0) == 0);
+            assert(labeler.live_count() == 1);
+            assert(labeler.finish() == 1);
+            assert(labeler.components()[0].area() == 7);
+            assert(labeler.components()[0].bounding_box() == cvx::rectangle2i(0, 0, 3, 3));
+        }
+
+        assert(labeler.label_count() == 2);
+        labeler.reset();
+        assert(labeler.label_count() == 0);
+
+        bool thrown = false;
+
+        try {
+            labeler.push_row(u, u + 2, 0);
+        } catch (cvx::exception&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using gray = unsigned char;
+
+// Label a thresholded copy of the image, the way it was done before
+std::size_t label_copy(const std::vector<gray>& image,
+                       std::vector<int>& labels,
+                       std::vector<cvx::connected_component>& components,
+                       std::size_t width,
+                       std::size_t height,
+                       unsigned char connectivity,
+                       gray lo,
+                       gray hi,
+                       cvx::feature_flag flags,
+                       cvx::label_engine engine) {
+    std::vector<int> binary(image.size());
+
+    for (std::size_t i = 0; i < image.size(); ++i) {
+        binary[i] = (image[i] >= lo && image[i] <= hi) ? 1 : 0;
+    }
+
+    return cvx::label_connected_components(binary.begin(),
+                                           binary.end(),
+                                           labels.begin(),
+                                           labels.end(),
+                                           std::back_inserter(components),
+                                           width,
+                                           height,
+                                           connectivity,
+                                           1,
+                                           0,
+                                           flags,
+                                           engine);
+}
+
+void check_components(const std::vector<cvx::connected_component>& a,
+                      const std::vector<cvx::connected_component>& b) {
+    assert(a.size() == b.size());
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        assert(a[i].label() == b[i].label());
+        assert(a[i].area() == b[i].area());
+        assert(a[i].bounding_box() == b[i].bounding_box());
+    }
+}
+
+int main() {
+    const std::size_t width = 83;
+    const std::size_t height = 57;
+    std::mt19937 rng(19);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<gray> image(width * height);
+
+    for (auto& e : image) {
+        e = static_cast<gray>(dist(rng));
+    }
+
+    const std::vector<gray> original(image);
+
+    try {
+        const cvx::label_engine engines[] = { cvx::label_engine::pixel,
+                                              cvx::label_engine::block,
+                                              cvx::label_engine::run };
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (cvx::label_engine engine : engines) {
+                const cvx::feature_flag flags = cvx::feature_flag::area | cvx::feature_flag::bounding_box;
+                std::vector<int> expected(image.size());
+                std::vector<cvx::connected_component> expected_ccs;
+                const std::size_t expected_count = label_copy(image, expected, expected_ccs, width, height,
+                                                              connectivity, 100, 255, flags, engine);
+
+                // Predicate without features
+                std::vector<int> labels(image.size());
+                std::size_t count = cvx::label_connected_components_if(image.begin(),
+                                                                       image.end(),
+                                                                       labels.begin(),
+                                                                       labels.end(),
+                                                                       width,
+                                                                       height,
+                                                                       connectivity,
+                                                                       [](gray e) { return e >= 100; },
+                                                                       engine);
+                assert(count == expected_count);
+                assert(labels == expected);
+
+                // Predicate with features
+                std::vector<cvx::connected_component> ccs;
+                std::fill(labels.begin(), labels.end(), 0);
+                count = cvx::label_connected_components_if(image.begin(),
+                                                           image.end(),
+                                                           labels.begin(),
+                                                           labels.end(),
+                                                           std::back_inserter(ccs),
+                                                           width,
+                                                           height,
+                                                           connectivity,
+                                                           [](gray e) { return e >= 100; },
+                                                           flags,
+                                                           engine);
+                assert(count == expected_count);
+                assert(labels == expected);
+                check_components(ccs, expected_ccs);
+
+                // Closed range, with and without features
+                expected_ccs.clear();
+                const std::size_t range_count = label_copy(image, expected, expected_ccs, width, height,
+                                                           connectivity, 60, 180, flags, engine);
+
+                count = cvx::label_connected_components_in_range(image.begin(),
+                                                                 image.end(),
+                                                                 labels.begin(),
+                                                                 labels.end(),
+                                                                 width,
+                                                                 height,
+                                                                 connectivity,
+                                                                 60,
+                                                                 180,
+                                                                 engine);
+                assert(count == range_count);
+                assert(labels == expected);
+
+                ccs.clear();
+                count = cvx::label_connected_components_in_range(image.begin(),
+                                                                 image.end(),
+                                                                 labels.begin(),
+                                                                 labels.end(),
+                                                                 std::back_inserter(ccs),
+                                                                 width,
+                                                                 height,
+                                                                 connectivity,
+                                                                 60,
+                                                                 180,
+                                                                 flags,
+                                                                 engine);
+                assert(count == range_count);
+                assert(labels == expected);
+                check_components(ccs, expected_ccs);
+
+                // A labeler through a threshold view
+                cvx::labeler<int> labeler(connectivity, flags, engine);
+                const auto input = cvx::make_threshold_view(image.begin(), image.end(), width, height, 60, 180);
+                cvx::array_view<std::vector<int>::iterator> output(labels.begin(), labels.end(), width, height);
+
+                assert(labeler.label(input, output, true, false) == range_count);
+                assert(labels == expected);
+                check_components(labeler.components(), expected_ccs);
+            }
+
+            // Contours go through the same view
+            const cvx::feature_flag flags = cvx::feature_flag::area | cvx::feature_flag::outer_contours;
+            std::vector<int> expected(image.size());
+            std::vector<cvx::connected_component> expected_ccs;
+            const std::size_t expected_count = label_copy(image, expected, expected_ccs, width, height,
+                                                          connectivity, 128, 255, flags, cvx::label_engine::pixel);
+
+            std::vector<int> labels(image.size());
+            std::vector<cvx::connected_component> ccs;
+            const std::size_t count = cvx::label_connected_components_if(image.begin(),
+                                                                         image.end(),
+                                                                         labels.begin(),
+                                                                         labels.end(),
+                                                                         std::back_inserter(ccs),
+                                                                         width,
+                                                                         height,
+                                                                         connectivity,
+                                                                         [](gray e) { return e >= 128; },
+                                                                         flags);
+            assert(count == expected_count);
+            assert(labels == expected);
+            assert(ccs.size() == expected_ccs.size());
+
+            for (std::size_t i = 0; i < ccs.size(); ++i) {
+                assert(ccs[i].contour() == expected_ccs[i].contour());
+            }
+        }
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    // The input is never written to
+    assert(image == original);
+
+    return 0;
+}
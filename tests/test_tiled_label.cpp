@@ -0,0 +1,158 @@
+#include <cvx.hpp>
+#include <assert.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+std::vector<std::uint8_t> make_image(std::size_t width, std::size_t height, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(0.55);
+    std::vector<std::uint8_t> image(width * height);
+
+    for (auto& e : image) {
+        e = dist(rng) ? 200 : 0;
+    }
+
+    return image;
+}
+
+void write_file(const std::string& path, const std::string& header, const std::vector<std::uint8_t>& data) {
+    std::ofstream out(path, std::ios::binary);
+    out << header;
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+std::vector<std::uint32_t> read_labels(const std::string& path, std::size_t count) {
+    std::vector<std::uint32_t> labels(count);
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(labels.data()), count * sizeof(std::uint32_t));
+    assert(in.gcount() == static_cast<std::streamsize>(count * sizeof(std::uint32_t)));
+
+    return labels;
+}
+
+// The tiled labels must partition the image like the in-memory labels,
+// with labels 1 to count
+void check(const std::vector<std::uint8_t>& image,
+           const std::vector<std::uint32_t>& labels,
+           std::size_t count,
+           std::size_t width,
+           std::size_t height,
+           unsigned char connectivity) {
+    std::vector<int> expected(image.size());
+    const std::size_t expected_count = cvx::label_connected_components(image.begin(),
+                                                                       image.end(),
+                                                                       expected.begin(),
+                                                                       expected.end(),
+                                                                       width,
+                                                                       height,
+                                                                       connectivity,
+                                                                       200,
+                                                                       0);
+    assert(count == expected_count);
+
+    std::map<std::uint32_t, int> forward;
+    std::map<int, std::uint32_t> backward;
+
+    for (std::size_t i = 0; i < image.size(); ++i) {
+        assert((labels[i] == 0) == (expected[i] == 0));
+        assert(labels[i] <= count);
+
+        if (labels[i]) {
+            assert(forward.emplace(labels[i], expected[i]).first->second == expected[i]);
+            assert(backward.emplace(expected[i], labels[i]).first->second == labels[i]);
+        }
+    }
+
+    assert(forward.size() == count);
+}
+
+int main() {
+    const std::string input_path = "test_tiled_label_input";
+    const std::string output_path = "test_tiled_label_output";
+    const std::size_t width = 77;
+    const std::size_t height = 103;
+
+    try {
+        const std::vector<std::uint8_t> image = make_image(width, height, 21);
+
+        // Pack the image as PBM with black foreground
+        const std::size_t stride = (width + 7) / 8;
+        std::vector<std::uint8_t> packed(stride * height, 0);
+
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                if (image[y * width + x]) {
+                    packed[y * stride + x / 8] |= static_cast<std::uint8_t>(0x80 >> (x % 8));
+                }
+            }
+        }
+
+        const cvx::label_engine engines[] = { cvx::label_engine::pixel, cvx::label_engine::run };
+
+        for (unsigned char connectivity : { 4, 8 }) {
+            for (cvx::label_engine engine : engines) {
+                // Budgets from a single row per tile to the whole image
+                for (std::size_t budget : { std::size_t(1), std::size_t(5000), std::size_t(1) << 30 }) {
+                    cvx::tiled_labeler labeler(connectivity, budget, engine);
+
+                    write_file(input_path, "", image);
+                    std::size_t count = labeler.label_raw_file(input_path, output_path, width, height, 0);
+                    check(image, read_labels(output_path, image.size()), count, width, height, connectivity);
+
+                    if (budget == 1) {
+                        assert(labeler.tile_rows() == 1);
+                        assert(labeler.tile_count() == height);
+                    } else if (budget == (std::size_t(1) << 30)) {
+                        assert(labeler.tile_count() == 1);
+                        assert(labeler.border_labels() > 0);
+                    }
+
+                    write_file(input_path, "P5\n# A comment\n77 103\n255\n", image);
+                    count = labeler.label_file(input_path, output_path);
+                    check(image, read_labels(output_path, image.size()), count, width, height, connectivity);
+
+                    write_file(input_path, "P4 77 103\n", packed);
+                    count = labeler.label_file(input_path, output_path);
+                    check(image, read_labels(output_path, image.size()), count, width, height, connectivity);
+                }
+            }
+        }
+
+        // Truncated and unknown files are rejected
+        cvx::tiled_labeler labeler(8);
+        bool thrown = false;
+
+        try {
+            write_file(input_path, "P5 77 103 255\n", std::vector<std::uint8_t>(10));
+            labeler.label_file(input_path, output_path);
+        } catch (cvx::exception&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+        thrown = false;
+
+        try {
+            write_file(input_path, "P2 77 103 255\n", image);
+            labeler.label_file(input_path, output_path);
+        } catch (cvx::exception&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    } catch (cvx::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+
+    return 0;
+}